@@ -0,0 +1,383 @@
+//
+//  GestureBenchmark.cpp
+//  OSXGestureControl
+//
+//  Copyright (c) 2013 Chris Willingham. All rights reserved.
+//
+//  Drives GestureDetector with synthetic frame streams and reports time and
+//  heap allocations per frame plus detection latency. Exits non-zero when a
+//  case doesn't detect what it should (each swipe stroke once, nothing
+//  else bar the false positives it pins), goes over --max-ns-per-frame or
+//  --max-allocs-per-frame, or over its own time budget times
+//  --budget-scale, so it can gate a build.
+//
+//    gesture-bench [--filter=substring] [--min-time=seconds]
+//                  [--max-ns-per-frame=N] [--max-allocs-per-frame=N]
+//                  [--budget-scale=X]
+//
+//  Each case's budget is set in addCase() from the work it does (hands,
+//  filtering, recognizers), with about twice the time it takes today; scale
+//  them for slower machines rather than loosening one global limit.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <cmath>
+#include <atomic>
+#include <chrono>
+#include <new>
+#include <string>
+#include <vector>
+#include "../GestureController/Core/GestureDetector.h"
+#include "SyntheticFrames.h"
+
+using namespace GestureCore;
+
+//////////////////////////////////////////////////////////////////////////
+//ALLOCATION COUNTING
+static std::atomic<size_t> allocations(0);
+
+void *operator new(size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *p = malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return malloc(size ? size : 1);
+}
+
+void *operator new[](size_t size, const std::nothrow_t &tag) noexcept
+{
+    return operator new(size, tag);
+}
+
+void operator delete(void *p) noexcept
+{
+    free(p);
+}
+
+void operator delete[](void *p) noexcept
+{
+    free(p);
+}
+
+//////////////////////////////////////////////////////////////////////////
+//CASES
+struct BenchmarkCase {
+    std::string name;
+    SyntheticParams params;
+    bool allRecognizers;
+    bool templateMatching;
+    FilterKind filter;
+    double budgetNsPerFrame;
+    // Detections the run must report: every stroke for a swipe, none for
+    // anything else unless allCases() pins a known false positive rate. A
+    // change in either direction fails the case.
+    size_t expectedDetections;
+};
+
+// Budget of a one or two hand case with only the default recognizers.
+static const double BaseBudgetNs = 500;
+
+struct CountingHandler : public GestureHandler
+{
+    size_t count;
+    CountingHandler() : count(0) {}
+    virtual void onGesture(const GestureEvent &) { count++; }
+};
+
+struct RecordingHandler : public GestureHandler
+{
+    std::vector<GestureEvent> events;
+    virtual void onGesture(const GestureEvent &event) { events.push_back(event); }
+};
+
+static const char *motionName(SyntheticMotion motion)
+{
+    switch (motion) {
+        case MotionIdle: return "idle";
+        case MotionSwipe: return "swipe";
+        case MotionCircle: return "circle";
+        case MotionTap: return "tap";
+    }
+    return "?";
+}
+
+static const char *directionName(Direction direction)
+{
+    switch (direction) {
+        case Up: return "up";
+        case Down: return "down";
+        case Left: return "left";
+        case Right: return "right";
+    }
+    return "?";
+}
+
+static void addCase(std::vector<BenchmarkCase> &cases, SyntheticMotion motion, Direction direction,
+                    int hands, int fingers, float noise, bool allRecognizers = false,
+                    bool templateMatching = false, FilterKind filter = FilterNone)
+{
+    BenchmarkCase benchmark;
+    benchmark.allRecognizers = allRecognizers;
+    benchmark.templateMatching = templateMatching;
+    benchmark.filter = filter;
+    benchmark.params.motion = motion;
+    benchmark.params.direction = direction;
+    benchmark.params.hands = hands;
+    benchmark.params.fingersPerHand = fingers;
+    // circles and taps peak at 400 mm/s, under the velocity swipe's 500
+    // mm/s horizontal threshold, so they only fire when the noise (averaged
+    // over the fingers) makes up the difference
+    benchmark.params.speed = motion == MotionSwipe ? 1500 : 400;
+    benchmark.params.velocityNoise = noise;
+    benchmark.params.positionNoise = noise / 50;
+    char name[128];
+    snprintf(name, sizeof(name), "%s%s%s/hands:%d/fingers:%d/noise:%g%s%s", motionName(motion),
+             motion == MotionSwipe ? "_" : "", motion == MotionSwipe ? directionName(direction) : "",
+             hands, fingers, noise, allRecognizers ? "/all" : templateMatching ? "/templates" : "",
+             filter == FilterOneEuro ? "/oneeuro" : filter == FilterKalman ? "/kalman" : "");
+    benchmark.name = name;
+    // 30 seconds at one stroke a second, see runCase
+    benchmark.expectedDetections = motion == MotionSwipe ? 30 : 0;
+    // per-pointable work grows with hands, filtering and the full set of
+    // recognizers roughly multiplies it
+    benchmark.budgetNsPerFrame = BaseBudgetNs;
+    if (hands > 2) {
+        benchmark.budgetNsPerFrame *= 2;
+    }
+    if (filter != FilterNone) {
+        benchmark.budgetNsPerFrame *= 2;
+    }
+    if (allRecognizers) {
+        benchmark.budgetNsPerFrame *= 2.5;
+    }
+    cases.push_back(benchmark);
+}
+
+static std::vector<BenchmarkCase> allCases()
+{
+    std::vector<BenchmarkCase> cases;
+    addCase(cases, MotionIdle, Right, 1, 5, 0);
+    addCase(cases, MotionIdle, Right, 1, 5, 200);
+    const Direction directions[] = { Up, Down, Left, Right };
+    for (int i = 0; i < 4; i++) {
+        addCase(cases, MotionSwipe, directions[i], 1, 5, 0);
+    }
+    addCase(cases, MotionSwipe, Right, 1, 5, 50);
+    addCase(cases, MotionSwipe, Right, 1, 5, 200);
+    addCase(cases, MotionSwipe, Right, 2, 5, 50);
+    addCase(cases, MotionSwipe, Right, 4, 8, 50);
+    addCase(cases, MotionIdle, Right, 0, 0, 0, true);
+    addCase(cases, MotionSwipe, Right, 2, 5, 50, true);
+    addCase(cases, MotionIdle, Right, 1, 5, 200, false, true);
+    addCase(cases, MotionSwipe, Up, 1, 5, 50, false, true);
+    addCase(cases, MotionSwipe, Right, 1, 5, 200, false, true);
+    addCase(cases, MotionCircle, Right, 1, 5, 0, false, true);
+    addCase(cases, MotionIdle, Right, 1, 5, 200, false, false, FilterOneEuro);
+    addCase(cases, MotionSwipe, Right, 1, 5, 200, false, false, FilterOneEuro);
+    addCase(cases, MotionSwipe, Right, 4, 8, 200, false, false, FilterOneEuro);
+    addCase(cases, MotionIdle, Right, 1, 5, 200, false, false, FilterKalman);
+    addCase(cases, MotionSwipe, Right, 1, 5, 200, false, false, FilterKalman);
+    addCase(cases, MotionSwipe, Right, 4, 8, 200, false, false, FilterKalman);
+    addCase(cases, MotionCircle, Right, 1, 5, 0);
+    addCase(cases, MotionCircle, Right, 1, 5, 200);
+    // A known false positive, not a target: the velocity swipe fires on a
+    // single frame over threshold, and noise averaged over five fingers
+    // still lifts the circle's 400 mm/s over the 500 mm/s horizontal one
+    // about twice a stroke. Pinned so a detector change that moves it
+    // either way shows up here.
+    cases.back().expectedDetections = 60;
+    addCase(cases, MotionTap, Right, 1, 5, 0);
+    addCase(cases, MotionTap, Right, 1, 5, 200);
+    return cases;
+}
+
+//////////////////////////////////////////////////////////////////////////
+//RUNNER
+struct BenchmarkResult {
+    double nsPerFrame;
+    double allocsPerFrame;
+    size_t detections;
+    size_t strokes;
+    double meanLatencyFrames;
+    double meanLatencyMicros;
+    int64_t maxLatencyMicros;
+};
+
+// The four swipe lines plus enough random curves to make "dozens".
+static void addTemplates(TemplateRecognizer &templates)
+{
+    templates.addSwipeTemplates();
+    uint32_t random = 12345;
+    for (int t = 0; t < 44; t++) {
+        Leap::Vector points[8];
+        for (int i = 1; i < 8; i++) {
+            random = random * 1664525 + 1013904223;
+            const float angle = (random >> 8) / 16777216.0f * 6.2831853f;
+            points[i] = points[i - 1] + Leap::Vector(cosf(angle), sinf(angle), 0) * 30;
+        }
+        templates.addTemplate(points, 8, CIRCLE_GESTURE, Up);
+    }
+}
+
+static void replay(GestureDetector &detector, const std::vector<FrameBuffer> &buffers)
+{
+    detector.reset();
+    for (size_t i = 0; i < buffers.size(); i++) {
+        detector.processFrame(buffers[i].snapshot());
+    }
+}
+
+static BenchmarkResult runCase(const BenchmarkCase &benchmark, double minSeconds)
+{
+    // 30 seconds of frames, generated up front so only detection is timed
+    const size_t frameCount = (size_t)benchmark.params.frameRate * 30;
+    SyntheticFrameSource source(benchmark.params);
+    std::vector<FrameBuffer> buffers;
+    source.generate(buffers, frameCount);
+
+    BenchmarkResult result;
+    memset(&result, 0, sizeof(result));
+
+    // untimed pass for detections and latency
+    GestureDetector detector;
+    if (benchmark.allRecognizers) {
+        detector.setEnabled(&detector.sdkSwipe(), true);
+        detector.setEnabled(&detector.circle(), true);
+        detector.setEnabled(&detector.keyTap(), true);
+        detector.setEnabled(&detector.pinch(), true);
+        detector.setEnabled(&detector.hold(), true);
+    }
+    if (benchmark.allRecognizers || benchmark.templateMatching) {
+        addTemplates(detector.templates());
+        detector.setEnabled(&detector.templates(), true);
+    }
+    if (benchmark.templateMatching) {
+        detector.setEnabled(&detector.velocitySwipe(), false);
+    }
+    FilterParams filter;
+    filter.kind = benchmark.filter;
+    detector.setFilter(filter);
+    RecordingHandler recorded;
+    recorded.events.reserve(frameCount);
+    detector.setHandler(&recorded);
+    replay(detector, buffers);
+    result.detections = recorded.events.size();
+    if (benchmark.params.motion == MotionSwipe) {
+        result.strokes = frameCount / benchmark.params.frameRate;
+    }
+    size_t matched = 0;
+    for (size_t i = 0; i < recorded.events.size(); i++) {
+        const GestureEvent &event = recorded.events[i];
+        int64_t onset;
+        if (benchmark.params.motion != MotionSwipe || event.type != SWIPE_GESTURE ||
+            event.direction != benchmark.params.direction ||
+            !source.strokeOnset(event.frameId, onset)) {
+            continue;
+        }
+        const int64_t micros = event.timestamp - source.timestampOf(onset);
+        result.meanLatencyFrames += (double)(event.frameId - onset);
+        result.meanLatencyMicros += (double)micros;
+        result.maxLatencyMicros = std::max(result.maxLatencyMicros, micros);
+        matched++;
+    }
+    if (benchmark.params.motion == MotionSwipe) {
+        // other recognizers (e.g. hold between strokes) aren't what's measured here
+        result.detections = matched;
+    }
+    if (matched > 0) {
+        result.meanLatencyFrames /= matched;
+        result.meanLatencyMicros /= matched;
+    }
+
+    // timed passes
+    CountingHandler counter;
+    detector.setHandler(&counter);
+    replay(detector, buffers);
+
+    typedef std::chrono::steady_clock Clock;
+    size_t passes = 0;
+    const size_t allocationsBefore = allocations.load();
+    const Clock::time_point start = Clock::now();
+    double elapsed = 0;
+    do {
+        replay(detector, buffers);
+        passes++;
+        elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    } while (elapsed < minSeconds);
+    const size_t frames = passes * frameCount;
+    result.nsPerFrame = elapsed * 1e9 / frames;
+    result.allocsPerFrame = (double)(allocations.load() - allocationsBefore) / frames;
+    return result;
+}
+
+static double doubleOption(const char *arg, const char *name, double current)
+{
+    const size_t length = strlen(name);
+    return strncmp(arg, name, length) == 0 ? atof(arg + length) : current;
+}
+
+int main(int argc, char **argv)
+{
+    std::string filter;
+    double minSeconds = 0.5;
+    double maxNsPerFrame = 0;
+    double maxAllocsPerFrame = -1;
+    double budgetScale = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--filter=", 9) == 0) {
+            filter = argv[i] + 9;
+        }
+        minSeconds = doubleOption(argv[i], "--min-time=", minSeconds);
+        maxNsPerFrame = doubleOption(argv[i], "--max-ns-per-frame=", maxNsPerFrame);
+        maxAllocsPerFrame = doubleOption(argv[i], "--max-allocs-per-frame=", maxAllocsPerFrame);
+        budgetScale = doubleOption(argv[i], "--budget-scale=", budgetScale);
+    }
+
+    printf("%-44s %10s %10s %12s %11s %14s %12s %12s\n", "Benchmark", "ns/frame", "budget", "allocs/frame",
+           "detections", "latency frames", "latency us", "max us");
+    printf("%s\n", std::string(44 + 10 + 10 + 12 + 11 + 14 + 12 + 12 + 7, '-').c_str());
+
+    int failures = 0;
+    const std::vector<BenchmarkCase> cases = allCases();
+    for (size_t i = 0; i < cases.size(); i++) {
+        const BenchmarkCase &benchmark = cases[i];
+        if (!filter.empty() && benchmark.name.find(filter) == std::string::npos) {
+            continue;
+        }
+        const BenchmarkResult result = runCase(benchmark, minSeconds);
+        char detections[32];
+        if (result.strokes > 0) {
+            snprintf(detections, sizeof(detections), "%zu/%zu", result.detections, result.strokes);
+        } else {
+            snprintf(detections, sizeof(detections), "%zu", result.detections);
+        }
+        const double budget = benchmark.budgetNsPerFrame * budgetScale;
+        printf("%-44s %10.1f %10.0f %12.3f %11s %14.1f %12.0f %12lld", benchmark.name.c_str(), result.nsPerFrame,
+               benchmark.budgetNsPerFrame, result.allocsPerFrame, detections, result.meanLatencyFrames,
+               result.meanLatencyMicros, (long long)result.maxLatencyMicros);
+        if (result.detections != benchmark.expectedDetections ||
+            (maxNsPerFrame > 0 && result.nsPerFrame > maxNsPerFrame) ||
+            (budget > 0 && result.nsPerFrame > budget) ||
+            (maxAllocsPerFrame >= 0 && result.allocsPerFrame > maxAllocsPerFrame)) {
+            printf("  FAILED");
+            failures++;
+        }
+        printf("\n");
+    }
+    return failures == 0 ? 0 : 1;
+}
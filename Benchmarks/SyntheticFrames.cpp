@@ -0,0 +1,180 @@
+//
+//  SyntheticFrames.cpp
+//  OSXGestureControl
+//
+//  Copyright (c) 2013 Chris Willingham. All rights reserved.
+//
+
+#include "SyntheticFrames.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace GestureCore {
+
+static const float Pi = 3.14159265f;
+
+SyntheticParams::SyntheticParams()
+    : hands(1), fingersPerHand(5), motion(MotionSwipe), direction(Right), speed(1500),
+      velocityNoise(0), positionNoise(0), frameRate(115), seed(1)
+{
+}
+
+static Leap::Vector directionVector(Direction direction)
+{
+    switch (direction) {
+        case Up: return Leap::Vector(0, 1, 0);
+        case Down: return Leap::Vector(0, -1, 0);
+        case Left: return Leap::Vector(-1, 0, 0);
+        case Right: return Leap::Vector(1, 0, 0);
+    }
+    return Leap::Vector();
+}
+
+SyntheticFrameSource::SyntheticFrameSource(const SyntheticParams &params, int64_t frameCount)
+    : _params(params), _frameCount(frameCount)
+{
+    // one stroke a second, lasting 150ms, starting half way through
+    _cycleFrames = std::max(params.frameRate, 2);
+    _strokeFrames = std::max(params.frameRate * 3 / 20, 1);
+    rewind();
+}
+
+void SyntheticFrameSource::rewind()
+{
+    _next = 0;
+    _random = _params.seed != 0 ? _params.seed : 1;
+}
+
+bool SyntheticFrameSource::nextFrame(FrameSnapshot &frame)
+{
+    if (_frameCount >= 0 && _next >= _frameCount) {
+        return false;
+    }
+    fill(_buffer, _next++);
+    frame = _buffer.snapshot();
+    return true;
+}
+
+void SyntheticFrameSource::generate(std::vector<FrameBuffer> &buffers, size_t count)
+{
+    buffers.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        fill(buffers[i], _next++);
+    }
+}
+
+bool SyntheticFrameSource::strokeOnset(int64_t frameId, int64_t &onsetId) const
+{
+    const int64_t phase = frameId % _cycleFrames;
+    if (phase < _cycleFrames / 2) {
+        return false;
+    }
+    onsetId = frameId - phase + _cycleFrames / 2;
+    return true;
+}
+
+int64_t SyntheticFrameSource::timestampOf(int64_t frameId) const
+{
+    return frameId * 1000000 / _params.frameRate;
+}
+
+float SyntheticFrameSource::gaussian()
+{
+    // xorshift64* into Box-Muller; stable across platforms for a given seed
+    float u[2];
+    for (int i = 0; i < 2; i++) {
+        _random ^= _random >> 12;
+        _random ^= _random << 25;
+        _random ^= _random >> 27;
+        const uint64_t bits = (_random * 2685821657736338717ULL) >> 40;
+        u[i] = ((float)bits + 1.0f) / 16777217.0f;
+    }
+    return sqrtf(-2.0f * logf(u[0])) * cosf(2.0f * Pi * u[1]);
+}
+
+void SyntheticFrameSource::fill(FrameBuffer &buffer, int64_t frameId)
+{
+    const float rate = (float)_params.frameRate;
+    const int phase = (int)(frameId % _cycleFrames);
+    const int strokeFrame = phase - _cycleFrames / 2;
+    const bool inStroke = strokeFrame >= 0 && strokeFrame < _strokeFrames;
+
+    Leap::Vector offset;
+    Leap::Vector velocity;
+    switch (_params.motion) {
+        case MotionIdle:
+            break;
+        case MotionSwipe:
+            if (inStroke) {
+                // speed ramps up and back down (sin profile), peaking at params.speed
+                const float s = (float)strokeFrame / _strokeFrames;
+                const Leap::Vector direction = directionVector(_params.direction);
+                velocity = direction * (_params.speed * sinf(Pi * s));
+                offset = direction * (_params.speed * _strokeFrames / rate * (1 - cosf(Pi * s)) / Pi);
+            } else if (strokeFrame >= _strokeFrames) {
+                // drift back to the start over the rest of the cycle
+                const int returnFrames = _cycleFrames - _cycleFrames / 2 - _strokeFrames;
+                const float distance = _params.speed * _strokeFrames / rate * 2 / Pi;
+                const Leap::Vector direction = directionVector(_params.direction);
+                velocity = direction * (-distance * rate / returnFrames);
+                offset = direction * (distance * (1 - (float)(strokeFrame - _strokeFrames) / returnFrames));
+            }
+            break;
+        case MotionCircle: {
+            // continuous, one turn a second at the given tangential speed
+            const float angle = 2.0f * Pi * (float)(frameId % _cycleFrames) / rate;
+            const float radius = _params.speed / (2.0f * Pi);
+            offset = Leap::Vector(radius * cosf(angle), radius * sinf(angle), 0);
+            velocity = Leap::Vector(-_params.speed * sinf(angle), _params.speed * cosf(angle), 0);
+            break;
+        }
+        case MotionTap:
+            if (inStroke) {
+                const bool down = strokeFrame * 2 < _strokeFrames;
+                const int depthFrames = std::min(strokeFrame, _strokeFrames - strokeFrame);
+                velocity = Leap::Vector(0, 0, down ? -_params.speed : _params.speed);
+                offset = Leap::Vector(0, 0, -_params.speed * depthFrames / rate);
+            }
+            break;
+    }
+
+    buffer.clear();
+    buffer.id = frameId;
+    buffer.timestamp = timestampOf(frameId);
+    const int hands = std::min<int>(_params.hands, MaxHands);
+    for (int h = 0; h < hands; h++) {
+        const Leap::Vector palm = Leap::Vector((h - (hands - 1) * 0.5f) * 160, 200, -20) + offset;
+        HandSnapshot &hand = buffer.hands[buffer.handCount++];
+        hand.id = h + 1;
+        hand.palmPosition = Float3::fromVector(palm);
+        hand.palmVelocity = Float3::fromVector(velocity);
+        hand.palmNormal = Float3::fromVector(Leap::Vector(0, -1, 0));
+        hand.direction = Float3::fromVector(Leap::Vector(0, 0, -1));
+        hand.sphereCenter = Float3::fromVector(palm + Leap::Vector(0, -40, -30));
+        hand.sphereRadius = 80;
+
+        for (int f = 0; f < _params.fingersPerHand && buffer.pointableCount < MaxPointables; f++) {
+            const uint32_t index = buffer.pointableCount++;
+            Leap::Vector tip = palm + Leap::Vector((f - (_params.fingersPerHand - 1) * 0.5f) * 20, 30, -30);
+            Leap::Vector tipVelocity = velocity;
+            if (_params.positionNoise > 0) {
+                tip += Leap::Vector(gaussian(), gaussian(), gaussian()) * _params.positionNoise;
+            }
+            if (_params.velocityNoise > 0) {
+                tipVelocity += Leap::Vector(gaussian(), gaussian(), gaussian()) * _params.velocityNoise;
+            }
+            buffer.pointableIds[index] = hand.id * 10 + f;
+            buffer.pointableHandIds[index] = hand.id;
+            buffer.pointableHandIndices[index] = (uint8_t)h;
+            buffer.tipPositions.set(index, tip);
+            buffer.tipVelocities.set(index, tipVelocity);
+            buffer.directions.set(index, Leap::Vector(0, 0, -1));
+            buffer.widths[index] = 15;
+            buffer.lengths[index] = 60;
+            buffer.flags[index] = PointableIsFinger;
+        }
+    }
+}
+
+}
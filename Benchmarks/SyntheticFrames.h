@@ -0,0 +1,79 @@
+//
+//  SyntheticFrames.h
+//  OSXGestureControl
+//
+//  Copyright (c) 2013 Chris Willingham. All rights reserved.
+//
+//  Deterministic FrameSource that fakes hands moving through a repeating
+//  one-second cycle: the hands hold still, perform one stroke (swipe, tap or
+//  a continuous circle) and drift back to rest. Used by the benchmarks to feed
+//  the detector without a device.
+//
+
+#ifndef OSXGestureControl_SyntheticFrames_h
+#define OSXGestureControl_SyntheticFrames_h
+
+#include <stdint.h>
+#include <vector>
+#include "../GestureController/Core/FrameSource.h"
+#include "../GestureController/Core/GestureTypes.h"
+
+namespace GestureCore {
+
+enum SyntheticMotion {
+    MotionIdle,
+    MotionSwipe,
+    MotionCircle,
+    MotionTap
+};
+
+struct SyntheticParams {
+    int hands;
+    int fingersPerHand;
+    SyntheticMotion motion;
+    Direction direction;    // swipe direction
+    float speed;            // peak mm/s of the stroke
+    float velocityNoise;    // standard deviation, mm/s
+    float positionNoise;    // standard deviation, mm
+    int frameRate;          // frames per second
+    uint64_t seed;
+
+    SyntheticParams();
+};
+
+class SyntheticFrameSource : public FrameSource
+{
+public:
+    explicit SyntheticFrameSource(const SyntheticParams &params, int64_t frameCount = -1);
+
+    // Produces frames until frameCount (if given) is reached.
+    virtual bool nextFrame(FrameSnapshot &frame);
+
+    // Fills buffers with the next count frames so a benchmark can replay
+    // them without paying for generation.
+    void generate(std::vector<FrameBuffer> &buffers, size_t count);
+
+    void rewind();
+
+    // The first frame of the stroke a gesture detected on frameId belongs
+    // to, or false if frameId isn't within a stroke's cycle.
+    bool strokeOnset(int64_t frameId, int64_t &onsetId) const;
+
+    int64_t timestampOf(int64_t frameId) const;
+
+private:
+    void fill(FrameBuffer &buffer, int64_t frameId);
+    float gaussian();
+
+    SyntheticParams _params;
+    int64_t _frameCount;
+    int64_t _next;
+    uint64_t _random;
+    int _cycleFrames;
+    int _strokeFrames;
+    FrameBuffer _buffer;
+};
+
+}
+
+#endif
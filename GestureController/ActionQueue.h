@@ -0,0 +1,37 @@
+//
+//  ActionQueue.h
+//  OSXGestureControl
+//
+//  Copyright (c) 2013 Chris Willingham. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+typedef enum {
+    MissionControlCommand = 1,
+    ExposeCommand
+} ActionCommandCode;
+
+// Posts keyboard/scroll events and app commands from a background thread so
+// the gesture callback returns immediately. See Core/ActionDispatcher.h.
+@interface ActionQueue : NSObject
+
+- (void) start;
+- (void) stop;
+
+// modifier down, key down, modifier up, key up, interval apart
+- (BOOL) pressKey:(int)key withModifier:(int)modifier interval:(NSTimeInterval)interval;
+- (BOOL) performCommand:(ActionCommandCode)command;
+
+// The same, marked as caused by the frame a gesture came from so posting
+// them completes its latency trace (see Gesture receivedNanos).
+- (BOOL) pressKey:(int)key withModifier:(int)modifier interval:(NSTimeInterval)interval tracedFrom:(int64_t)receivedNanos;
+- (BOOL) performCommand:(ActionCommandCode)command tracedFrom:(int64_t)receivedNanos;
+
+- (BOOL) scrollX:(NSInteger)x scrollY:(NSInteger)y;
+
+// The GestureCore::ScrollEngine that posts continuous scrolling through
+// this queue's events, at its own fixed rate rather than one per frame.
+- (void *) scrollEngine;
+
+@end
@@ -0,0 +1,115 @@
+//
+//  ActionQueue.mm
+//  OSXGestureControl
+//
+//  Copyright (c) 2013 Chris Willingham. All rights reserved.
+//
+
+#import "ActionQueue.h"
+#import <Cocoa/Cocoa.h>
+#include "Core/ActionDispatcher.h"
+#include "Core/ScrollEngine.h"
+
+extern "C" void CoreDockSendNotification(CFStringRef notification, void *unknown);
+
+// Turns dispatcher actions into CGEvents / workspace calls.
+class SystemActionSink : public GestureCore::ActionSink
+{
+public:
+    virtual void perform(const GestureCore::Action &action)
+    {
+        switch (action.kind) {
+            case GestureCore::ActionKey: {
+                CGEventRef keyEvent = CGEventCreateKeyboardEvent(NULL, (CGKeyCode)action.code, action.down);
+                CGEventPost(kCGHIDEventTap, keyEvent);
+                CFRelease(keyEvent);
+                break;
+            }
+            case GestureCore::ActionScroll: {
+                CGEventRef scrollEvent = CGEventCreateScrollWheelEvent(NULL, kCGScrollEventUnitPixel, 2, action.dy, action.dx);
+                CGEventPost(kCGHIDEventTap, scrollEvent);
+                CFRelease(scrollEvent);
+                break;
+            }
+            case GestureCore::ActionCommand:
+                performCommand((ActionCommandCode)action.code);
+                break;
+        }
+    }
+
+private:
+    void performCommand(ActionCommandCode command)
+    {
+        // AppKit wants these on the main thread
+        dispatch_async(dispatch_get_main_queue(), ^{
+            switch (command) {
+                case MissionControlCommand:
+                    [[NSWorkspace sharedWorkspace] launchApplication:@"Mission Control"];
+                    break;
+                case ExposeCommand:
+                    CoreDockSendNotification(CFSTR("com.apple.expose.front.awake"), NULL);
+                    break;
+            }
+        });
+    }
+};
+
+@implementation ActionQueue{
+    SystemActionSink sink;
+    GestureCore::ActionDispatcher *dispatcher;
+    GestureCore::ScrollEngine *scrollEngine;
+}
+
+-(id)init{
+    if(self = [super init]){
+        dispatcher = new GestureCore::ActionDispatcher(sink);
+        scrollEngine = new GestureCore::ScrollEngine();
+    }
+    return self;
+}
+
+-(void)dealloc{
+    delete scrollEngine;
+    delete dispatcher;
+}
+
+-(void) start{
+    dispatcher->start();
+    scrollEngine->start(sink);
+}
+
+-(void) stop{
+    scrollEngine->stop();
+    dispatcher->stop();
+}
+
+-(void *) scrollEngine{
+    return (void *)scrollEngine;
+}
+
+-(BOOL) pressKey:(int)key withModifier:(int)modifier interval:(NSTimeInterval)interval{
+    return [self pressKey:key withModifier:modifier interval:interval tracedFrom:0];
+}
+
+-(BOOL) pressKey:(int)key withModifier:(int)modifier interval:(NSTimeInterval)interval tracedFrom:(int64_t)receivedNanos{
+    GestureCore::ActionSequence sequence = GestureCore::ActionSequence::keyChord(modifier, key, (int64_t)(interval * 1000000));
+    return dispatcher->enqueue(sequence.tracedFrom(receivedNanos));
+}
+
+-(BOOL) scrollX:(NSInteger)x scrollY:(NSInteger)y{
+    GestureCore::ActionSequence sequence;
+    sequence.scroll((int32_t)x, (int32_t)y, 0);
+    return dispatcher->enqueue(sequence);
+}
+
+-(BOOL) performCommand:(ActionCommandCode)command{
+    return [self performCommand:command tracedFrom:0];
+}
+
+-(BOOL) performCommand:(ActionCommandCode)command tracedFrom:(int64_t)receivedNanos{
+    GestureCore::ActionSequence sequence;
+    sequence.command(command, 0).tracedFrom(receivedNanos);
+    return dispatcher->enqueue(sequence);
+}
+
+@end
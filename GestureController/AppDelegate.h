@@ -8,15 +8,16 @@
 
 #import <Cocoa/Cocoa.h>
 
+@class ActionQueue;
+
 @interface AppDelegate : NSObject <NSApplicationDelegate>{
     NSWindow *window;
     NSStatusItem * statusItem;
+    ActionQueue *actionQueue;
 }
 @property (weak) IBOutlet NSMenu *statusMenu;
 
 @property (assign) IBOutlet NSWindow *window;
--(void) pressKey:(int)key down:(BOOL)pressDown;
--(void) scrollX:(NSInteger)x scrollY:(NSInteger)y;
 - (IBAction)onQuitClick:(id)sender;
 - (IBAction)onAboutClick:(id)sender;
 
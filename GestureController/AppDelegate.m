@@ -10,6 +10,7 @@
 #import "GestureListener.h"
 #import "Gesture.h"
 #import "Sample.h"
+#import "ActionQueue.h"
 #import <Carbon/Carbon.h>
 
 @implementation AppDelegate
@@ -17,50 +18,63 @@
 - (void)applicationDidFinishLaunching:(NSNotification *)aNotification
 {
     // Insert code here to initialize your application
+    actionQueue = [[ActionQueue alloc] init];
+    [actionQueue start];
     GestureListener *listener = [[GestureListener alloc] init];
     
+    // e.g. -GestureConfig ~/gestures.conf, reloaded whenever it's saved
+    NSString *configPath = [[NSUserDefaults standardUserDefaults] stringForKey:@"GestureConfig"];
+    if (configPath != nil) {
+        [listener watchConfig:[configPath stringByExpandingTildeInPath]];
+    }
+    
+    // e.g. -RecordFramesTo ~/session.lprc on the command line
+    NSString *recordingPath = [[NSUserDefaults standardUserDefaults] stringForKey:@"RecordFramesTo"];
+    if (recordingPath != nil) {
+        [listener startRecording:[recordingPath stringByExpandingTildeInPath]];
+    }
+    
+    // e.g. -PublishFrames YES to let other processes read frames and
+    // gestures, see Core/SharedFrame.h
+    if ([[NSUserDefaults standardUserDefaults] boolForKey:@"PublishFrames"]) {
+        [listener publishFrames:nil];
+    }
+    
+    // e.g. -TraceLatency 10 logs per stage latency every 10 seconds
+    NSTimeInterval traceInterval = [[NSUserDefaults standardUserDefaults] doubleForKey:@"TraceLatency"];
+    if (traceInterval > 0) {
+        [listener traceLatencyEvery:traceInterval];
+    }
+    
+    // e.g. -Scroll YES for two finger scrolling
+    if ([[NSUserDefaults standardUserDefaults] boolForKey:@"Scroll"]) {
+        [listener scrollWith:actionQueue];
+    }
+    
     [listener setGestureEvent:^(Gesture *g) {
         
-//        if(g.type == SCROLL_GESTURE){
-//            //sNSLog(@"avgVelocity: %@", [g avgVelocity]);
-//            [self scrollX:g.avgVelocity.x/10 scrollY:g.avgVelocity.y/10];
-//            return;
-//        }
+        if(g.type != SWIPE_GESTURE){
+            return;
+        }
         
         switch ([g direction]) {
             case Up:
                 NSLog(@"Gesturing Up");
                 
                 //NSLog(@"MissionControl");
-                [[NSWorkspace sharedWorkspace] launchApplication:@"Mission Control"];
+                [actionQueue performCommand:MissionControlCommand tracedFrom:g.receivedNanos];
                 break;
             case Down:
                 NSLog(@"Gesturing Down");
-                CoreDockSendNotification(@"com.apple.expose.front.awake", NULL);
+                [actionQueue performCommand:ExposeCommand tracedFrom:g.receivedNanos];
                 break;
             case Left:
                 NSLog(@"Gesturing Left with %ld fingers", [g fingers]);
-                [self pressKey:kVK_Control down:true];
-                [NSThread sleepForTimeInterval: 0.1]; // 100 mS delay
-                [self pressKey:kVK_LeftArrow down:true];
-                
-                [NSThread sleepForTimeInterval: 0.1]; // 100 mS delay
-                
-                [self pressKey:kVK_Control down:false];
-                [NSThread sleepForTimeInterval: 0.1]; // 100 mS delay
-                [self pressKey:kVK_LeftArrow down:false];
+                [actionQueue pressKey:kVK_LeftArrow withModifier:kVK_Control interval:0.1 tracedFrom:g.receivedNanos]; // 100 mS between steps
                 break;
             case Right:
                 NSLog(@"Gesturing Right");
-                [self pressKey:kVK_Control down:true];
-                [NSThread sleepForTimeInterval: 0.1]; // 100 mS delay
-                [self pressKey:kVK_RightArrow down:true];
-                
-                [NSThread sleepForTimeInterval: 0.1]; // 100 mS delay
-                
-                [self pressKey:kVK_Control down:false];
-                [NSThread sleepForTimeInterval: 0.1]; // 100 mS delay
-                [self pressKey:kVK_RightArrow down:false];
+                [actionQueue pressKey:kVK_RightArrow withModifier:kVK_Control interval:0.1 tracedFrom:g.receivedNanos]; // 100 mS between steps
                 break;
             default:
                 break;
@@ -70,6 +84,12 @@
     [listener run];
 }
 
+- (void)applicationWillTerminate:(NSNotification *)aNotification
+{
+    // releases any key a queued chord still holds down
+    [actionQueue stop];
+}
+
 -(void)awakeFromNib{
     statusItem = [[NSStatusBar systemStatusBar] statusItemWithLength:NSVariableStatusItemLength];
     [statusItem setMenu:[self statusMenu]];
@@ -82,28 +102,6 @@
     [window close];
 }
 
--(void) scrollX:(NSInteger)x scrollY:(NSInteger)y{
-    CGWheelCount wheelCount = 2; // 1 for Y-only, 2 for Y-X, 3 for Y-X-Z
-    int32_t xScroll = x; // Negative for right
-    int32_t yScroll = y; // Negative for down
-    //NSLog(@"Scroll X: %ld, Y: %ld", (long)x, (long)y);
-    CGEventRef cgEvent = CGEventCreateScrollWheelEvent(NULL, kCGScrollEventUnitPixel, wheelCount, yScroll, xScroll);
-    
-    // You can post the CGEvent to the event stream to have it automatically sent to the window under the cursor
-    CGEventPost(kCGHIDEventTap, cgEvent);
-    
-//    NSEvent *theEvent = [NSEvent eventWithCGEvent:cgEvent];
-    CFRelease(cgEvent);
-}
-
--(void) pressKey:(int)key down:(BOOL)pressDown{
-    CGEventRef downEvent = CGEventCreateKeyboardEvent(NULL, key, pressDown);
-    
-    CGEventPost(kCGHIDEventTap, downEvent);
-    
-    CFRelease(downEvent);
-}
-
 - (IBAction)onQuitClick:(id)sender {
     [[NSApplication sharedApplication] terminate:nil];
 }
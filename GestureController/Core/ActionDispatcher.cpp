@@ -0,0 +1,260 @@
+//
+//  ActionDispatcher.cpp
+//  OSXGestureControl
+//
+//  Copyright (c) 2013 Chris Willingham. All rights reserved.
+//
+
+#include "ActionDispatcher.h"
+#include "LatencyTrace.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace GestureCore {
+
+//////////////////////////////////////////////////////////////////////////
+//SEQUENCE
+ActionSequence &ActionSequence::add(int64_t atMicros, const Action &action)
+{
+    if (_count < MaxSteps) {
+        _steps[_count].offsetMicros = atMicros;
+        _steps[_count].action = action;
+        _count++;
+    }
+    return *this;
+}
+
+ActionSequence &ActionSequence::keyDown(int32_t key, int64_t atMicros)
+{
+    Action action = { ActionKey, key, true, 0, 0 };
+    return add(atMicros, action);
+}
+
+ActionSequence &ActionSequence::keyUp(int32_t key, int64_t atMicros)
+{
+    Action action = { ActionKey, key, false, 0, 0 };
+    return add(atMicros, action);
+}
+
+ActionSequence &ActionSequence::scroll(int32_t dx, int32_t dy, int64_t atMicros)
+{
+    Action action = { ActionScroll, 0, false, dx, dy };
+    return add(atMicros, action);
+}
+
+ActionSequence &ActionSequence::command(int32_t code, int64_t atMicros)
+{
+    Action action = { ActionCommand, code, false, 0, 0 };
+    return add(atMicros, action);
+}
+
+ActionSequence ActionSequence::keyChord(int32_t modifier, int32_t key, int64_t stepMicros)
+{
+    ActionSequence sequence;
+    sequence.keyDown(modifier, 0)
+            .keyDown(key, stepMicros)
+            .keyUp(modifier, 2 * stepMicros)
+            .keyUp(key, 3 * stepMicros);
+    return sequence;
+}
+
+int64_t ActionSequence::durationMicros() const
+{
+    int64_t duration = 0;
+    for (uint32_t i = 0; i < _count; i++) {
+        duration = std::max(duration, _steps[i].offsetMicros);
+    }
+    return duration;
+}
+
+//////////////////////////////////////////////////////////////////////////
+//DISPATCHER
+ActionDispatcher::ActionDispatcher(ActionSink &sink)
+    : _sink(sink), _running(false), _nextOrder(0), _timelineEnd(0), _performed(0), _dropped(0), _maxLateness(0), _heldCount(0)
+{
+    _pending.reserve(MaxPendingSteps);
+}
+
+ActionDispatcher::~ActionDispatcher()
+{
+    stop();
+}
+
+int64_t ActionDispatcher::nowMicros()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void ActionDispatcher::start()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_running) {
+        return;
+    }
+    _running = true;
+    _worker = std::thread(&ActionDispatcher::workerLoop, this);
+}
+
+void ActionDispatcher::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_running) {
+            return;
+        }
+        _running = false;
+    }
+    _wakeup.notify_one();
+    _worker.join();
+
+    // release what the worker pressed, in timeline order, and nothing else:
+    // a quit mid-chord mustn't press the chord's key or switch Spaces
+    std::sort_heap(_pending.begin(), _pending.end(), LaterStep());
+    for (std::vector<ScheduledStep>::reverse_iterator it = _pending.rbegin(); it != _pending.rend(); ++it) {
+        if (it->action.kind == ActionKey && !it->action.down && isHeld(it->action.code)) {
+            perform(*it);
+        }
+    }
+    _pending.clear();
+    _timelineEnd = 0;
+}
+
+bool ActionDispatcher::isHeld(int32_t code) const
+{
+    for (uint32_t i = 0; i < _heldCount; i++) {
+        if (_heldKeys[i] == code) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ActionDispatcher::enqueue(const ActionSequence &sequence)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_pending.size() + sequence.count() > MaxPendingSteps) {
+            _dropped++;
+            return false;
+        }
+        const int64_t start = std::max(nowMicros(), _timelineEnd);
+        const bool traced = sequence.tracedFromNanos() != 0;
+        const int64_t queued = traced ? LatencyTrace::shared().begin() : 0;
+        for (uint32_t i = 0; i < sequence.count(); i++) {
+            ScheduledStep step;
+            step.due = start + sequence.step(i).offsetMicros;
+            step.order = _nextOrder++;
+            step.action = sequence.step(i).action;
+            step.tracedFrom = i == 0 && queued != 0 ? sequence.tracedFromNanos() : 0;
+            step.queuedNanos = i == 0 ? queued : 0;
+            _pending.push_back(step);
+            std::push_heap(_pending.begin(), _pending.end(), LaterStep());
+        }
+        _timelineEnd = start + sequence.durationMicros();
+    }
+    _wakeup.notify_one();
+    return true;
+}
+
+void ActionDispatcher::perform(const ScheduledStep &step)
+{
+    const int64_t lateness = nowMicros() - step.due;
+    _sink.perform(step.action);
+    if (step.queuedNanos != 0) {
+        LatencyTrace &trace = LatencyTrace::shared();
+        const int64_t now = LatencyTrace::nowNanos();
+        trace.record(TraceAction, now - step.queuedNanos);
+        trace.record(TraceEndToEnd, now - step.tracedFrom);
+    }
+    std::lock_guard<std::mutex> lock(_mutex);
+    _performed++;
+    _maxLateness = std::max(_maxLateness, lateness);
+    if (step.action.kind != ActionKey) {
+        return;
+    }
+    if (step.action.down) {
+        if (_heldCount < MaxHeldKeys) {
+            _heldKeys[_heldCount++] = step.action.code;
+        }
+        return;
+    }
+    for (uint32_t i = 0; i < _heldCount; i++) {
+        if (_heldKeys[i] == step.action.code) {
+            _heldKeys[i] = _heldKeys[--_heldCount];
+            break;
+        }
+    }
+}
+
+void ActionDispatcher::workerLoop()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (_running) {
+        if (_pending.empty()) {
+            _wakeup.wait(lock);
+            continue;
+        }
+        const int64_t due = _pending.front().due;
+        const int64_t now = nowMicros();
+        if (now < due) {
+            _wakeup.wait_for(lock, std::chrono::microseconds(due - now));
+            continue;
+        }
+        std::pop_heap(_pending.begin(), _pending.end(), LaterStep());
+        const ScheduledStep step = _pending.back();
+        _pending.pop_back();
+        lock.unlock();
+        perform(step);
+        lock.lock();
+    }
+}
+
+size_t ActionDispatcher::pendingSteps() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _pending.size();
+}
+
+uint64_t ActionDispatcher::actionsPerformed() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _performed;
+}
+
+uint64_t ActionDispatcher::sequencesDropped() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _dropped;
+}
+
+int64_t ActionDispatcher::maxLatenessMicros() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _maxLateness;
+}
+
+//////////////////////////////////////////////////////////////////////////
+//RECORDING SINK
+void RecordingActionSink::perform(const Action &action)
+{
+    Entry entry;
+    entry.timeMicros = ActionDispatcher::nowMicros();
+    entry.action = action;
+    std::lock_guard<std::mutex> lock(_mutex);
+    _entries.push_back(entry);
+}
+
+std::vector<RecordingActionSink::Entry> RecordingActionSink::entries() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _entries;
+}
+
+void RecordingActionSink::clear()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _entries.clear();
+}
+
+}
@@ -0,0 +1,173 @@
+//
+//  ActionDispatcher.h
+//  OSXGestureControl
+//
+//  Copyright (c) 2013 Chris Willingham. All rights reserved.
+//
+//  Runs the output side of a gesture (key presses, scrolls, app commands)
+//  on its own thread so frame processing never waits on it. Actions are
+//  queued as short timelines and handed to an ActionSink when they are due.
+//
+
+#ifndef OSXGestureControl_ActionDispatcher_h
+#define OSXGestureControl_ActionDispatcher_h
+
+#include <stdint.h>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace GestureCore {
+
+enum ActionKind {
+    ActionKey,
+    ActionScroll,
+    ActionCommand
+};
+
+struct Action {
+    ActionKind kind;
+    int32_t code;   // virtual key code or application command
+    bool down;      // ActionKey only
+    int32_t dx;     // ActionScroll only
+    int32_t dy;
+};
+
+// Where actions end up: CGEvents on the Mac, a RecordingActionSink in tests.
+class ActionSink
+{
+public:
+    virtual ~ActionSink() {}
+    virtual void perform(const Action &action) = 0;
+};
+
+struct ActionStep {
+    int64_t offsetMicros;   // from the start of the sequence
+    Action action;
+};
+
+class ActionSequence
+{
+public:
+    enum { MaxSteps = 8 };
+
+    ActionSequence() : _count(0), _tracedFrom(0) {}
+
+    ActionSequence &keyDown(int32_t key, int64_t atMicros);
+    ActionSequence &keyUp(int32_t key, int64_t atMicros);
+    ActionSequence &scroll(int32_t dx, int32_t dy, int64_t atMicros);
+    ActionSequence &command(int32_t code, int64_t atMicros);
+
+    // modifier down, key down, modifier up, key up; stepMicros apart
+    static ActionSequence keyChord(int32_t modifier, int32_t key, int64_t stepMicros);
+
+    // Marks the sequence as caused by a frame received at receivedNanos, so
+    // posting its first step completes that frame's LatencyTrace.
+    ActionSequence &tracedFrom(int64_t receivedNanos)
+    {
+        _tracedFrom = receivedNanos;
+        return *this;
+    }
+    int64_t tracedFromNanos() const { return _tracedFrom; }
+
+    uint32_t count() const { return _count; }
+    const ActionStep &step(uint32_t index) const { return _steps[index]; }
+    int64_t durationMicros() const;
+
+private:
+    ActionSequence &add(int64_t atMicros, const Action &action);
+
+    ActionStep _steps[MaxSteps];
+    uint32_t _count;
+    int64_t _tracedFrom;
+};
+
+class ActionDispatcher
+{
+public:
+    enum { MaxPendingSteps = 64, MaxHeldKeys = 8 };
+
+    explicit ActionDispatcher(ActionSink &sink);
+    ~ActionDispatcher();
+
+    void start();
+    // Joins the worker thread and drops whatever is still pending, except
+    // the key-ups for keys it has already pressed, which are posted straight
+    // away so no key is left held down. A key or command that hasn't run
+    // yet never does.
+    void stop();
+
+    // Never waits for earlier sequences to finish. Sequences run back to
+    // back: one starts once the previous one's last step is due, so two
+    // chords can't interleave. Returns false if the queue is full.
+    bool enqueue(const ActionSequence &sequence);
+
+    size_t pendingSteps() const;
+    uint64_t actionsPerformed() const;
+    uint64_t sequencesDropped() const;
+    // Worst observed delay between when a step was due and when it ran.
+    int64_t maxLatenessMicros() const;
+
+    static int64_t nowMicros();
+
+private:
+    ActionDispatcher(const ActionDispatcher &);
+    ActionDispatcher &operator=(const ActionDispatcher &);
+
+    struct ScheduledStep {
+        int64_t due;
+        uint64_t order;
+        Action action;
+        // first step of a traced sequence only, otherwise 0
+        int64_t tracedFrom;
+        int64_t queuedNanos;
+    };
+    struct LaterStep {
+        bool operator()(const ScheduledStep &a, const ScheduledStep &b) const
+        {
+            return a.due != b.due ? a.due > b.due : a.order > b.order;
+        }
+    };
+
+    void workerLoop();
+    void perform(const ScheduledStep &step);
+    // whether code is among _heldKeys; the worker must not be running
+    bool isHeld(int32_t code) const;
+
+    ActionSink &_sink;
+    mutable std::mutex _mutex;
+    std::condition_variable _wakeup;
+    std::thread _worker;
+    bool _running;
+    std::vector<ScheduledStep> _pending;   // min-heap on due time
+    uint64_t _nextOrder;
+    int64_t _timelineEnd;
+    uint64_t _performed;
+    uint64_t _dropped;
+    int64_t _maxLateness;
+    int32_t _heldKeys[MaxHeldKeys];     // pressed and not yet released
+    uint32_t _heldCount;
+};
+
+// Keeps every action it is given, for tests and offline runs.
+class RecordingActionSink : public ActionSink
+{
+public:
+    struct Entry {
+        int64_t timeMicros;
+        Action action;
+    };
+
+    virtual void perform(const Action &action);
+    std::vector<Entry> entries() const;
+    void clear();
+
+private:
+    mutable std::mutex _mutex;
+    std::vector<Entry> _entries;
+};
+
+}
+
+#endif
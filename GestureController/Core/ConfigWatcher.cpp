@@ -0,0 +1,91 @@
+//
+//  ConfigWatcher.cpp
+//  OSXGestureControl
+//
+//  Copyright (c) 2013 Chris Willingham. All rights reserved.
+//
+
+#include "ConfigWatcher.h"
+
+#include <sys/stat.h>
+#include <chrono>
+
+namespace GestureCore {
+
+ConfigWatcher::ConfigWatcher(ConfigStore &store) : _store(store), _stopping(false), _failedLoads(0), _lastErrorLine(0)
+{
+}
+
+ConfigWatcher::~ConfigWatcher()
+{
+    stop();
+}
+
+ConfigWatcher::FileStamp ConfigWatcher::stampOf(const char *path)
+{
+    FileStamp stamp = { 0, 0, 0 };
+    struct stat info;
+    if (stat(path, &info) == 0) {
+        stamp.inode = (uint64_t)info.st_ino;
+        stamp.size = (int64_t)info.st_size;
+#ifdef __APPLE__
+        stamp.modifiedNanos = (int64_t)info.st_mtimespec.tv_sec * 1000000000 + info.st_mtimespec.tv_nsec;
+#else
+        stamp.modifiedNanos = (int64_t)info.st_mtim.tv_sec * 1000000000 + info.st_mtim.tv_nsec;
+#endif
+    }
+    return stamp;
+}
+
+bool ConfigWatcher::reload()
+{
+    int line = 0;
+    if (_store.loadFile(_path.c_str(), &line)) {
+        return true;
+    }
+    _lastErrorLine.store(line, std::memory_order_relaxed);
+    _failedLoads.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+bool ConfigWatcher::start(const char *path, int intervalMillis)
+{
+    stop();
+    _path = path;
+    _stamp = stampOf(path);
+    const bool loaded = reload();
+    _stopping = false;
+    _thread = std::thread(&ConfigWatcher::run, this, intervalMillis > 0 ? intervalMillis : 1);
+    return loaded;
+}
+
+void ConfigWatcher::stop()
+{
+    if (!_thread.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        _stopping = true;
+    }
+    _wake.notify_all();
+    _thread.join();
+}
+
+void ConfigWatcher::run(int intervalMillis)
+{
+    std::unique_lock<std::mutex> lock(_lock);
+    while (!_wake.wait_for(lock, std::chrono::milliseconds(intervalMillis), [this]{ return _stopping; })) {
+        const FileStamp stamp = stampOf(_path.c_str());
+        if (stamp == _stamp) {
+            continue;
+        }
+        _stamp = stamp;
+        // a file that's gone leaves the last config in place
+        if (stamp.inode != 0) {
+            reload();
+        }
+    }
+}
+
+}
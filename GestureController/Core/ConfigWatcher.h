@@ -0,0 +1,76 @@
+//
+//  ConfigWatcher.h
+//  OSXGestureControl
+//
+//  Copyright (c) 2013 Chris Willingham. All rights reserved.
+//
+//  Reloads a config file into a ConfigStore whenever it changes, from a
+//  thread of its own, so thresholds can be tuned while the detector keeps
+//  running. It polls the file's size, inode and modification time, which
+//  also catches editors that save by writing a new file and renaming it
+//  over the old one.
+//
+
+#ifndef OSXGestureControl_ConfigWatcher_h
+#define OSXGestureControl_ConfigWatcher_h
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "GestureConfig.h"
+
+namespace GestureCore {
+
+class ConfigWatcher
+{
+public:
+    explicit ConfigWatcher(ConfigStore &store);
+    ~ConfigWatcher();
+
+    // Loads path now and starts watching it, checking every intervalMillis.
+    // Returns whether the first load succeeded; the file is watched either
+    // way, so fixing or creating it later still takes effect.
+    bool start(const char *path, int intervalMillis = 500);
+    void stop();
+
+    // Loads that failed, and the line of the most recent failure (0 when
+    // the file couldn't be read). A failed load keeps the previous config.
+    uint64_t failedLoads() const { return _failedLoads.load(std::memory_order_relaxed); }
+    int lastErrorLine() const { return _lastErrorLine.load(std::memory_order_relaxed); }
+
+private:
+    ConfigWatcher(const ConfigWatcher &);
+    ConfigWatcher &operator=(const ConfigWatcher &);
+
+    // What's compared between polls; all zero for a missing file.
+    struct FileStamp {
+        uint64_t inode;
+        int64_t size;
+        int64_t modifiedNanos;
+
+        bool operator==(const FileStamp &other) const
+        {
+            return inode == other.inode && size == other.size && modifiedNanos == other.modifiedNanos;
+        }
+    };
+
+    static FileStamp stampOf(const char *path);
+    bool reload();
+    void run(int intervalMillis);
+
+    ConfigStore &_store;
+    std::string _path;
+    FileStamp _stamp;
+    std::thread _thread;
+    std::mutex _lock;
+    std::condition_variable _wake;
+    bool _stopping;
+    std::atomic<uint64_t> _failedLoads;
+    std::atomic<int> _lastErrorLine;
+};
+
+}
+
+#endif
@@ -0,0 +1,174 @@
+//
+//  FrameHistory.cpp
+//  OSXGestureControl
+//
+//  Copyright (c) 2013 Chris Willingham. All rights reserved.
+//
+
+#include "FrameHistory.h"
+
+namespace GestureCore {
+
+FrameHistory::FrameHistory(size_t capacity) : _newest(0), _count(0)
+{
+    setCapacity(capacity);
+}
+
+void FrameHistory::setCapacity(size_t capacity)
+{
+    std::vector<Entry>(capacity).swap(_entries);
+    _newest = 0;
+    _count = 0;
+}
+
+void FrameHistory::push(const FrameSnapshot &frame)
+{
+    if (_entries.empty()) {
+        return;
+    }
+    if (_count > 0 && frame.id <= _entries[_newest].frame.id) {
+        _count = 0;
+    }
+    _newest = _count == 0 ? 0 : (_newest + 1) % _entries.size();
+    if (_count < _entries.size()) {
+        _count++;
+    }
+
+    Entry &entry = _entries[_newest];
+    FrameBuffer &buffer = entry.frame;
+    buffer.copyFrom(frame);
+    entry.hands.clear();
+    for (uint32_t i = 0; i < buffer.handCount; i++) {
+        entry.hands.insert(buffer.hands[i].id, (uint8_t)i);
+    }
+    entry.pointables.clear();
+    for (uint32_t i = 0; i < buffer.pointableCount; i++) {
+        entry.pointables.insert(buffer.pointableIds[i], (uint8_t)i);
+    }
+    entry.gestures.clear();
+    for (uint32_t i = 0; i < buffer.gestureCount; i++) {
+        entry.gestures.insert(buffer.gestures[i].id, (uint8_t)i);
+    }
+}
+
+const FrameHistory::Entry *FrameHistory::entry(size_t age) const
+{
+    if (age >= _count) {
+        return NULL;
+    }
+    return &_entries[(_newest + _entries.size() - age) % _entries.size()];
+}
+
+const FrameBuffer *FrameHistory::at(size_t age) const
+{
+    const Entry *held = entry(age);
+    return held != NULL ? &held->frame : NULL;
+}
+
+long FrameHistory::ageOf(int64_t frameId) const
+{
+    if (_count == 0 || frameId > at(0)->id || frameId < at(_count - 1)->id) {
+        return -1;
+    }
+    // with consecutive ids the distance from the newest id is the age
+    const int64_t guess = at(0)->id - frameId;
+    if (guess < (int64_t)_count && at((size_t)guess)->id == frameId) {
+        return (long)guess;
+    }
+    // the controller skipped some; ids fall as age rises, so bisect
+    size_t low = 0;
+    size_t high = _count - 1;
+    while (low <= high) {
+        const size_t middle = low + (high - low) / 2;
+        const int64_t id = at(middle)->id;
+        if (id == frameId) {
+            return (long)middle;
+        }
+        // the newest id is >= frameId, so middle > 0 here
+        if (id > frameId) {
+            low = middle + 1;
+        } else {
+            high = middle - 1;
+        }
+    }
+    return -1;
+}
+
+const FrameBuffer *FrameHistory::byId(int64_t frameId) const
+{
+    const long age = ageOf(frameId);
+    return age >= 0 ? at((size_t)age) : NULL;
+}
+
+int FrameHistory::handIndex(size_t age, int32_t handId) const
+{
+    const Entry *held = entry(age);
+    return held != NULL ? held->hands.find(handId) : -1;
+}
+
+int FrameHistory::pointableIndex(size_t age, int32_t pointableId) const
+{
+    const Entry *held = entry(age);
+    return held != NULL ? held->pointables.find(pointableId) : -1;
+}
+
+int FrameHistory::gestureIndex(size_t age, int32_t gestureId) const
+{
+    const Entry *held = entry(age);
+    return held != NULL ? held->gestures.find(gestureId) : -1;
+}
+
+const HandSnapshot *FrameHistory::hand(size_t age, int32_t handId) const
+{
+    const int index = handIndex(age, handId);
+    return index >= 0 ? &at(age)->hands[index] : NULL;
+}
+
+const GestureSnapshot *FrameHistory::gesture(size_t age, int32_t gestureId) const
+{
+    const int index = gestureIndex(age, gestureId);
+    return index >= 0 ? &at(age)->gestures[index] : NULL;
+}
+
+bool FrameHistory::translation(int32_t handId, size_t age, Leap::Vector &out) const
+{
+    const HandSnapshot *now = hand(0, handId);
+    const HandSnapshot *then = hand(age, handId);
+    if (now == NULL || then == NULL) {
+        return false;
+    }
+    out = now->palmPosition.toVector() - then->palmPosition.toVector();
+    return true;
+}
+
+bool FrameHistory::sweptAngle(int32_t circleId, float &radians) const
+{
+    const GestureSnapshot *now = gesture(0, circleId);
+    if (now == NULL || now->type != SdkGestureCircle) {
+        return false;
+    }
+    const GestureSnapshot *previous = gesture(1, circleId);
+    radians = previous != NULL ? (now->progress - previous->progress) * 2 * Leap::PI : 0;
+    return true;
+}
+
+bool FrameHistory::averageTipVelocity(int32_t pointableId, size_t frames, Leap::Vector &out) const
+{
+    Leap::Vector sum;
+    int found = 0;
+    for (size_t age = 0; age < frames && age < _count; age++) {
+        const int index = pointableIndex(age, pointableId);
+        if (index >= 0) {
+            const FrameBuffer &frame = *at(age);
+            sum += frame.tipVelocities.arrays()[index];
+            found++;
+        }
+    }
+    if (found == 0) {
+        return false;
+    }
+    out = sum / (float)found;
+    return true;
+}
+
+}
@@ -0,0 +1,134 @@
+//
+//  FrameHistory.h
+//  OSXGestureControl
+//
+//  Copyright (c) 2013 Chris Willingham. All rights reserved.
+//
+//  The last few frames the detector saw, kept as FrameBuffers in a ring
+//  allocated up front. Lookback (translation since a frame, swept angle of a
+//  circle, velocity over several frames) reads straight out of the ring
+//  instead of asking the controller for frame(n), which builds a whole new
+//  Leap::Frame each time.
+//
+//  Frames are found by age (0 is the newest) or by id, both in constant
+//  time while ids are consecutive. Each frame also carries small hash maps
+//  from hand, pointable and gesture ids to their index in that frame.
+//
+
+#ifndef OSXGestureControl_FrameHistory_h
+#define OSXGestureControl_FrameHistory_h
+
+#include <stddef.h>
+#include <string.h>
+#include <vector>
+#include "FrameSnapshot.h"
+
+namespace GestureCore {
+
+// Open addressing map from an id to an index below 0xFF, with 1 << Bits
+// slots. Sized to stay at most half full for its kind of id.
+template<int Bits>
+class IdIndex
+{
+public:
+    IdIndex() { clear(); }
+
+    void clear() { memset(_indices, Empty, sizeof(_indices)); }
+
+    // Keeps the first index seen for an id.
+    void insert(int32_t id, uint8_t index)
+    {
+        uint32_t slot = hash(id);
+        while (_indices[slot] != Empty) {
+            if (_ids[slot] == id) {
+                return;
+            }
+            slot = (slot + 1) & (Size - 1);
+        }
+        _ids[slot] = id;
+        _indices[slot] = index;
+    }
+
+    // -1 if id isn't there.
+    int find(int32_t id) const
+    {
+        uint32_t slot = hash(id);
+        while (_indices[slot] != Empty) {
+            if (_ids[slot] == id) {
+                return _indices[slot];
+            }
+            slot = (slot + 1) & (Size - 1);
+        }
+        return -1;
+    }
+
+private:
+    enum { Size = 1 << Bits, Empty = 0xFF };
+
+    static uint32_t hash(int32_t id) { return ((uint32_t)id * 2654435761u) >> (32 - Bits); }
+
+    int32_t _ids[Size];
+    uint8_t _indices[Size];
+};
+
+class FrameHistory
+{
+public:
+    explicit FrameHistory(size_t capacity = 0);
+
+    // Drops everything held and reallocates for capacity frames.
+    void setCapacity(size_t capacity);
+    size_t capacity() const { return _entries.size(); }
+    size_t size() const { return _count; }
+
+    // Copies frame in, truncated to FrameBuffer's capacities, pushing out the
+    // oldest once full. A frame id at or below the newest one (a restarted
+    // controller or another recording) starts the history over.
+    void push(const FrameSnapshot &frame);
+    void clear() { _count = 0; }
+
+    // NULL once age reaches size().
+    const FrameBuffer *at(size_t age) const;
+
+    // The age of frameId, or -1 if it isn't held.
+    long ageOf(int64_t frameId) const;
+    const FrameBuffer *byId(int64_t frameId) const;
+
+    // Indices into the frame at age, or -1 if it doesn't have the id.
+    int handIndex(size_t age, int32_t handId) const;
+    int pointableIndex(size_t age, int32_t pointableId) const;
+    int gestureIndex(size_t age, int32_t gestureId) const;
+
+    const HandSnapshot *hand(size_t age, int32_t handId) const;
+    const GestureSnapshot *gesture(size_t age, int32_t gestureId) const;
+
+    // Palm movement of handId between age frames ago and now. False unless
+    // the hand is in both.
+    bool translation(int32_t handId, size_t age, Leap::Vector &out) const;
+
+    // Radians a circle gesture went round since the previous frame; zero on
+    // the frame it starts. False if the newest frame doesn't have it.
+    bool sweptAngle(int32_t circleId, float &radians) const;
+
+    // Mean tip velocity of a pointable over the newest frames it's in, out
+    // of the last frames frames. False if it's in none of them.
+    bool averageTipVelocity(int32_t pointableId, size_t frames, Leap::Vector &out) const;
+
+private:
+    struct Entry {
+        FrameBuffer frame;
+        IdIndex<3> hands;
+        IdIndex<6> pointables;
+        IdIndex<5> gestures;
+    };
+
+    const Entry *entry(size_t age) const;
+
+    std::vector<Entry> _entries;
+    size_t _newest;
+    size_t _count;
+};
+
+}
+
+#endif
@@ -0,0 +1,274 @@
+//
+//  FrameRecording.cpp
+//  OSXGestureControl
+//
+//  Copyright (c) 2013 Chris Willingham. All rights reserved.
+//
+
+#include "FrameRecording.h"
+
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace GestureCore {
+
+// Byte offsets of each section inside a record. Gestures come first since
+// they are the only section that needs 8 byte alignment.
+struct RecordLayout {
+    size_t gestures;
+    size_t hands;
+    size_t ids;
+    size_t handIds;
+    size_t tipPositions;
+    size_t tipVelocities;
+    size_t directions;
+    size_t widths;
+    size_t lengths;
+    size_t handIndices;
+    size_t flags;
+    size_t size;
+
+    RecordLayout(uint32_t handCount, uint32_t pointableCount, uint32_t gestureCount)
+    {
+        gestures = sizeof(FrameRecordHeader);
+        hands = gestures + gestureCount * sizeof(GestureSnapshot);
+        ids = hands + handCount * sizeof(HandSnapshot);
+        handIds = ids + pointableCount * sizeof(int32_t);
+        tipPositions = handIds + pointableCount * sizeof(int32_t);
+        tipVelocities = tipPositions + 3 * pointableCount * sizeof(float);
+        directions = tipVelocities + 3 * pointableCount * sizeof(float);
+        widths = directions + 3 * pointableCount * sizeof(float);
+        lengths = widths + pointableCount * sizeof(float);
+        handIndices = lengths + pointableCount * sizeof(float);
+        flags = handIndices + pointableCount * sizeof(uint8_t);
+        size = (flags + pointableCount * sizeof(uint8_t) + 7) & ~(size_t)7;
+    }
+};
+
+static bool validHeader(const RecordingHeader &header)
+{
+    return memcmp(header.magic, RecordingMagic, sizeof(RecordingMagic)) == 0 &&
+           header.version == RecordingVersion &&
+           header.headerSize == sizeof(RecordingHeader);
+}
+
+// Where the last complete record ends, walking the records' headers from
+// the start. A recorder killed mid-write leaves a partial record after it.
+static long completeRecordsEnd(FILE *file, long fileSize)
+{
+    long end = sizeof(RecordingHeader);
+    FrameRecordHeader header;
+    while (fseek(file, end, SEEK_SET) == 0 && fread(&header, sizeof(header), 1, file) == 1) {
+        const RecordLayout layout(header.handCount, header.pointableCount, header.gestureCount);
+        if (header.size != layout.size || header.size > (unsigned long)(fileSize - end)) {
+            break;
+        }
+        end += header.size;
+    }
+    return end;
+}
+
+static bool writeVectors(const VectorArrays &vectors, uint32_t n, FILE *file)
+{
+    return fwrite(vectors.x, sizeof(float), n, file) == n &&
+           fwrite(vectors.y, sizeof(float), n, file) == n &&
+           fwrite(vectors.z, sizeof(float), n, file) == n;
+}
+
+static VectorArrays readVectors(const uint8_t *section, uint32_t n)
+{
+    const float *values = (const float *)section;
+    VectorArrays vectors = { values, values + n, values + 2 * n };
+    return vectors;
+}
+
+//////////////////////////////////////////////////////////////////////////
+//RECORDER
+FrameRecorder::FrameRecorder() : _file(NULL), _framesWritten(0)
+{
+}
+
+FrameRecorder::~FrameRecorder()
+{
+    close();
+}
+
+bool FrameRecorder::open(const char *path)
+{
+    close();
+    FILE *file = fopen(path, "a+b");
+    if (file == NULL) {
+        return false;
+    }
+
+    RecordingHeader header;
+    fseek(file, 0, SEEK_END);
+    if (ftell(file) == 0) {
+        memcpy(header.magic, RecordingMagic, sizeof(RecordingMagic));
+        header.version = RecordingVersion;
+        header.headerSize = sizeof(RecordingHeader);
+        header.reserved = 0;
+        if (fwrite(&header, sizeof(header), 1, file) != 1) {
+            fclose(file);
+            return false;
+        }
+    } else {
+        const long size = ftell(file);
+        fseek(file, 0, SEEK_SET);
+        if (fread(&header, sizeof(header), 1, file) != 1 || !validHeader(header)) {
+            fclose(file);
+            return false;
+        }
+        // appending after a partial record would leave replay reading its
+        // header over the new frames, so cut it off first
+        const long end = completeRecordsEnd(file, size);
+        if (end < size && ftruncate(fileno(file), end) != 0) {
+            fclose(file);
+            return false;
+        }
+        fseek(file, 0, SEEK_END);
+    }
+    _file = file;
+    _framesWritten = 0;
+    return true;
+}
+
+void FrameRecorder::close()
+{
+    if (_file != NULL) {
+        fclose(_file);
+        _file = NULL;
+    }
+}
+
+bool FrameRecorder::write(const FrameSnapshot &frame)
+{
+    if (_file == NULL) {
+        return false;
+    }
+    const uint32_t n = frame.pointableCount;
+    const RecordLayout layout(frame.handCount, n, frame.gestureCount);
+    static const uint8_t padding[8] = { 0 };
+
+    FrameRecordHeader header;
+    header.size = (uint32_t)layout.size;
+    header.handCount = frame.handCount;
+    header.pointableCount = n;
+    header.gestureCount = frame.gestureCount;
+    header.id = frame.id;
+    header.timestamp = frame.timestamp;
+
+    // stdio buffers these, so one frame is normally a single write(2) or less
+    bool ok = fwrite(&header, sizeof(header), 1, _file) == 1;
+    ok = ok && fwrite(frame.gestures, sizeof(GestureSnapshot), frame.gestureCount, _file) == frame.gestureCount;
+    ok = ok && fwrite(frame.hands, sizeof(HandSnapshot), frame.handCount, _file) == frame.handCount;
+    ok = ok && fwrite(frame.pointables.ids, sizeof(int32_t), n, _file) == n;
+    ok = ok && fwrite(frame.pointables.handIds, sizeof(int32_t), n, _file) == n;
+    ok = ok && writeVectors(frame.pointables.tipPositions, n, _file);
+    ok = ok && writeVectors(frame.pointables.tipVelocities, n, _file);
+    ok = ok && writeVectors(frame.pointables.directions, n, _file);
+    ok = ok && fwrite(frame.pointables.widths, sizeof(float), n, _file) == n;
+    ok = ok && fwrite(frame.pointables.lengths, sizeof(float), n, _file) == n;
+    ok = ok && fwrite(frame.pointables.handIndices, sizeof(uint8_t), n, _file) == n;
+    ok = ok && fwrite(frame.pointables.flags, sizeof(uint8_t), n, _file) == n;
+    const size_t pad = layout.size - (layout.flags + n);
+    ok = ok && fwrite(padding, 1, pad, _file) == pad;
+    if (ok) {
+        _framesWritten++;
+    }
+    return ok;
+}
+
+//////////////////////////////////////////////////////////////////////////
+//REPLAY
+RecordingFrameSource::RecordingFrameSource() : _data(NULL), _size(0), _offset(0), _firstRecord(0)
+{
+}
+
+RecordingFrameSource::~RecordingFrameSource()
+{
+    close();
+}
+
+bool RecordingFrameSource::open(const char *path)
+{
+    close();
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(RecordingHeader)) {
+        ::close(fd);
+        return false;
+    }
+    void *data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        return false;
+    }
+    if (!validHeader(*(const RecordingHeader *)data)) {
+        munmap(data, (size_t)st.st_size);
+        return false;
+    }
+    madvise(data, (size_t)st.st_size, MADV_SEQUENTIAL);
+
+    _data = (const uint8_t *)data;
+    _size = (size_t)st.st_size;
+    _firstRecord = sizeof(RecordingHeader);
+    _offset = _firstRecord;
+    return true;
+}
+
+void RecordingFrameSource::close()
+{
+    if (_data != NULL) {
+        munmap((void *)_data, _size);
+        _data = NULL;
+        _size = 0;
+        _offset = 0;
+    }
+}
+
+void RecordingFrameSource::rewind()
+{
+    _offset = _firstRecord;
+}
+
+bool RecordingFrameSource::nextFrame(FrameSnapshot &frame)
+{
+    if (_data == NULL || _size - _offset < sizeof(FrameRecordHeader)) {
+        return false;
+    }
+    const uint8_t *record = _data + _offset;
+    const FrameRecordHeader &header = *(const FrameRecordHeader *)record;
+    const RecordLayout layout(header.handCount, header.pointableCount, header.gestureCount);
+    if (header.size != layout.size || header.size > _size - _offset) {
+        return false;
+    }
+    _offset += header.size;
+
+    frame.id = header.id;
+    frame.timestamp = header.timestamp;
+    frame.receivedNanos = 0;
+    frame.gestureCount = header.gestureCount;
+    frame.gestures = (const GestureSnapshot *)(record + layout.gestures);
+    frame.handCount = header.handCount;
+    frame.hands = (const HandSnapshot *)(record + layout.hands);
+    frame.pointableCount = header.pointableCount;
+    frame.pointables.ids = (const int32_t *)(record + layout.ids);
+    frame.pointables.handIds = (const int32_t *)(record + layout.handIds);
+    frame.pointables.tipPositions = readVectors(record + layout.tipPositions, header.pointableCount);
+    frame.pointables.tipVelocities = readVectors(record + layout.tipVelocities, header.pointableCount);
+    frame.pointables.directions = readVectors(record + layout.directions, header.pointableCount);
+    frame.pointables.widths = (const float *)(record + layout.widths);
+    frame.pointables.lengths = (const float *)(record + layout.lengths);
+    frame.pointables.handIndices = (const uint8_t *)(record + layout.handIndices);
+    frame.pointables.flags = (const uint8_t *)(record + layout.flags);
+    return true;
+}
+
+}
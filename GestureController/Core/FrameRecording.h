@@ -0,0 +1,117 @@
+//
+//  FrameRecording.h
+//  OSXGestureControl
+//
+//  Copyright (c) 2013 Chris Willingham. All rights reserved.
+//
+//  Append-only binary recording of FrameSnapshots and a FrameSource that
+//  replays one straight out of a memory mapping.
+//
+//  File layout (native byte order, little-endian on every platform we ship):
+//
+//    RecordingHeader
+//    record*
+//
+//  where each record is
+//
+//    FrameRecordHeader
+//    GestureSnapshot[gestureCount]
+//    HandSnapshot[handCount]
+//    int32_t ids[pointableCount]
+//    int32_t handIds[pointableCount]
+//    float tipPositions[3][pointableCount]    x, y then z
+//    float tipVelocities[3][pointableCount]
+//    float directions[3][pointableCount]
+//    float widths[pointableCount]
+//    float lengths[pointableCount]
+//    uint8_t handIndices[pointableCount]
+//    uint8_t flags[pointableCount]
+//
+//  padded so that FrameRecordHeader::size is a multiple of 8. Replay hands
+//  out FrameSnapshots that point into the mapping, nothing is copied.
+//
+
+#ifndef OSXGestureControl_FrameRecording_h
+#define OSXGestureControl_FrameRecording_h
+
+#include <stddef.h>
+#include <stdio.h>
+#include "FrameSnapshot.h"
+#include "FrameSource.h"
+
+namespace GestureCore {
+
+static const char RecordingMagic[4] = { 'L', 'P', 'R', 'C' };
+// 2: pointable vectors stored per component, hand index per pointable
+static const uint32_t RecordingVersion = 2;
+
+struct RecordingHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t headerSize;
+    uint32_t reserved;
+};
+
+struct FrameRecordHeader {
+    uint32_t size;
+    uint32_t handCount;
+    uint32_t pointableCount;
+    uint32_t gestureCount;
+    int64_t id;
+    int64_t timestamp;
+};
+
+class FrameRecorder
+{
+public:
+    FrameRecorder();
+    ~FrameRecorder();
+
+    // Creates the file, or appends to it if it already holds a recording of
+    // the same version, first dropping any partial record a recorder killed
+    // mid-write left at the end. Returns false if the file can't be used.
+    bool open(const char *path);
+    void close();
+    bool isOpen() const { return _file != NULL; }
+
+    bool write(const FrameSnapshot &frame);
+    size_t framesWritten() const { return _framesWritten; }
+
+private:
+    FrameRecorder(const FrameRecorder &);
+    FrameRecorder &operator=(const FrameRecorder &);
+
+    FILE *_file;
+    size_t _framesWritten;
+};
+
+class RecordingFrameSource : public FrameSource
+{
+public:
+    RecordingFrameSource();
+    virtual ~RecordingFrameSource();
+
+    bool open(const char *path);
+    void close();
+    bool isOpen() const { return _data != NULL; }
+
+    // Starts replay over from the first frame.
+    void rewind();
+
+    // A truncated final record (e.g. the recorder was killed mid-write)
+    // ends the replay rather than failing it.
+    virtual bool nextFrame(FrameSnapshot &frame);
+
+private:
+    RecordingFrameSource(const RecordingFrameSource &);
+    RecordingFrameSource &operator=(const RecordingFrameSource &);
+
+    const uint8_t *_data;
+    size_t _size;
+    size_t _offset;
+    size_t _firstRecord;
+};
+
+}
+
+#endif
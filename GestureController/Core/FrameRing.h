@@ -0,0 +1,158 @@
+//
+//  FrameRing.h
+//  OSXGestureControl
+//
+//  Copyright (c) 2013 Chris Willingham. All rights reserved.
+//
+//  Single-producer/single-consumer ring of fixed-size slots that never
+//  blocks the producer: when the consumer falls behind, the oldest unread
+//  slot is overwritten and counted as dropped.
+//
+//  Both sides advance the tail with a CAS. The producer only claims a slot
+//  after moving the tail past it, and the consumer only keeps a copy if its
+//  own CAS on that same tail value succeeds, so a copy that raced with an
+//  overwrite is always thrown away.
+//
+
+#ifndef OSXGestureControl_FrameRing_h
+#define OSXGestureControl_FrameRing_h
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include "FrameSnapshot.h"
+#include "FrameSource.h"
+
+namespace GestureCore {
+
+template<typename T, size_t Capacity>
+class SpscRing
+{
+public:
+    SpscRing() : _head(0), _tail(0), _dropped(0) {}
+
+    // Producer: returns the slot to fill, evicting the oldest entry if the
+    // ring is full. Publish it with commitWrite().
+    T &beginWrite()
+    {
+        const uint64_t head = _head.load(std::memory_order_relaxed);
+        uint64_t tail = _tail.load(std::memory_order_acquire);
+        while (head - tail >= Capacity) {
+            if (_tail.compare_exchange_weak(tail, tail + 1, std::memory_order_acq_rel)) {
+                _dropped.fetch_add(1, std::memory_order_relaxed);
+                break;
+            }
+        }
+        return _slots[head % Capacity];
+    }
+
+    void commitWrite()
+    {
+        _head.store(_head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    void push(const T &value)
+    {
+        beginWrite() = value;
+        commitWrite();
+    }
+
+    // Consumer: copies the oldest entry into value.
+    bool pop(T &value)
+    {
+        uint64_t tail = _tail.load(std::memory_order_acquire);
+        for (;;) {
+            if (tail == _head.load(std::memory_order_acquire)) {
+                return false;
+            }
+            value = _slots[tail % Capacity];
+            if (_tail.compare_exchange_strong(tail, tail + 1, std::memory_order_acq_rel)) {
+                return true;
+            }
+            // the producer overwrote that slot, tail now holds the new oldest
+        }
+    }
+
+    size_t size() const
+    {
+        return (size_t)(_head.load(std::memory_order_acquire) - _tail.load(std::memory_order_acquire));
+    }
+
+    uint64_t written() const { return _head.load(std::memory_order_relaxed); }
+    uint64_t dropped() const { return _dropped.load(std::memory_order_relaxed); }
+
+private:
+    SpscRing(const SpscRing &);
+    SpscRing &operator=(const SpscRing &);
+
+    // padded apart so the two threads don't false-share a cache line
+    // (padding rather than alignas, since Objective-C ivars and plain new
+    // don't honour over-alignment)
+    T _slots[Capacity];
+    uint8_t _pad0[64];
+    std::atomic<uint64_t> _head;
+    uint8_t _pad1[64 - sizeof(std::atomic<uint64_t>)];
+    std::atomic<uint64_t> _tail;
+    std::atomic<uint64_t> _dropped;
+    uint8_t _pad2[64 - 2 * sizeof(std::atomic<uint64_t>)];
+};
+
+// 32 frames is ~100 ms at the device's slowest frame rate.
+typedef SpscRing<FrameBuffer, 32> FrameRing;
+
+// Lets the consumer sleep until the producer has something. The producer
+// never takes the lock; a wakeup lost to that race is covered by the
+// timeout passed to wait().
+class FrameSignal
+{
+public:
+    FrameSignal() : _pending(false) {}
+
+    void notify()
+    {
+        _pending.store(true, std::memory_order_release);
+        _condition.notify_one();
+    }
+
+    void wait(std::chrono::microseconds timeout)
+    {
+        if (_pending.exchange(false, std::memory_order_acq_rel)) {
+            return;
+        }
+        std::unique_lock<std::mutex> lock(_mutex);
+        _condition.wait_for(lock, timeout);
+        _pending.store(false, std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<bool> _pending;
+    std::mutex _mutex;
+    std::condition_variable _condition;
+};
+
+// Drains a FrameRing, oldest frame first.
+class FrameRingSource : public FrameSource
+{
+public:
+    explicit FrameRingSource(FrameRing &ring) : _ring(ring) {}
+
+    virtual bool nextFrame(FrameSnapshot &frame)
+    {
+        if (!_ring.pop(_current)) {
+            return false;
+        }
+        frame = _current.snapshot();
+        return true;
+    }
+
+private:
+    FrameRing &_ring;
+    FrameBuffer _current;
+};
+
+}
+
+#endif
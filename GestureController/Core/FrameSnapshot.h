@@ -0,0 +1,252 @@
+//
+//  FrameSnapshot.h
+//  OSXGestureControl
+//
+//  Copyright (c) 2013 Chris Willingham. All rights reserved.
+//
+//  Leap::Frame-shaped plain data that the detection core works on. A
+//  FrameSnapshot is a read-only view (counts plus pointers); whoever
+//  produced it owns the storage, which only has to stay valid until the
+//  next frame is requested. FrameBuffer is the fixed-capacity owner used
+//  when a frame has to be captured and kept.
+//
+
+#ifndef OSXGestureControl_FrameSnapshot_h
+#define OSXGestureControl_FrameSnapshot_h
+
+#include <stdint.h>
+#include <string.h>
+#include <type_traits>
+#include "../include/LeapMath.h"
+
+namespace GestureCore {
+
+enum {
+    MaxHands = 4,
+    MaxPointables = 32,
+    MaxGestures = 16
+};
+
+enum PointableFlags {
+    PointableIsFinger = 1 << 0,
+    PointableIsTool = 1 << 1
+};
+
+// Hand index of a pointable that isn't attached to a captured hand.
+static const uint8_t NoHandIndex = 0xFF;
+
+// Plain three floats. Leap::Vector has a user-declared copy constructor, which
+// would stop the snapshot structs from being trivially copyable.
+struct Float3 {
+    float x;
+    float y;
+    float z;
+
+    Leap::Vector toVector() const { return Leap::Vector(x, y, z); }
+
+    static Float3 fromVector(const Leap::Vector &vector)
+    {
+        Float3 value = { vector.x, vector.y, vector.z };
+        return value;
+    }
+};
+
+struct HandSnapshot {
+    int32_t id;
+    Float3 palmPosition;
+    Float3 palmVelocity;
+    Float3 palmNormal;
+    Float3 direction;
+    Float3 sphereCenter;
+    float sphereRadius;
+};
+
+// One pointable as a single record, for callers that want every attribute
+// of a pointable together rather than FrameBuffer's per-attribute arrays.
+struct PointableSnapshot {
+    int32_t id;
+    int32_t handId;     // -1 when not attached to a hand
+    Float3 tipPosition;
+    Float3 tipVelocity;
+    Float3 direction;
+    float width;
+    float length;
+    uint8_t flags;      // PointableFlags
+};
+
+// Leap::Gesture::Type and Leap::Gesture::State values as stored in
+// GestureSnapshot, so the core doesn't need Leap.h.
+enum SdkGestureType {
+    SdkGestureSwipe = 1,
+    SdkGestureCircle = 4,
+    SdkGestureScreenTap = 5,
+    SdkGestureKeyTap = 6
+};
+
+enum SdkGestureState {
+    SdkGestureStart = 1,
+    SdkGestureUpdate = 2,
+    SdkGestureStop = 3
+};
+
+// Common fields of the SDK gestures. position/direction are the swipe or
+// tap position and direction; for a circle they hold center and normal.
+struct GestureSnapshot {
+    int32_t id;
+    int32_t type;   // LeapGestureType values
+    int32_t state;  // LeapGestureState values
+    int32_t pointableId;
+    int64_t duration;
+    Float3 position;
+    Float3 direction;
+    float speed;
+    float progress;
+    float radius;
+};
+
+// A per-pointable vector attribute split into one array per component, so a
+// pass over e.g. tip z is a linear scan.
+struct VectorArrays {
+    const float *x;
+    const float *y;
+    const float *z;
+
+    Leap::Vector operator[](uint32_t i) const { return Leap::Vector(x[i], y[i], z[i]); }
+};
+
+// One array per attribute, all pointableCount long.
+struct PointableArrays {
+    const int32_t *ids;
+    const int32_t *handIds;
+    const uint8_t *handIndices;  // into FrameSnapshot::hands, or NoHandIndex
+    VectorArrays tipPositions;
+    VectorArrays tipVelocities;
+    VectorArrays directions;
+    const float *widths;
+    const float *lengths;
+    const uint8_t *flags;
+};
+
+struct FrameSnapshot {
+    int64_t id;
+    int64_t timestamp;
+    int64_t receivedNanos;  // LatencyTrace clock when it arrived, 0 if untraced
+    uint32_t handCount;
+    const HandSnapshot *hands;
+    uint32_t pointableCount;
+    PointableArrays pointables;
+    uint32_t gestureCount;
+    const GestureSnapshot *gestures;
+};
+
+struct VectorStorage {
+    float x[MaxPointables];
+    float y[MaxPointables];
+    float z[MaxPointables];
+
+    void set(uint32_t i, const Leap::Vector &vector)
+    {
+        x[i] = vector.x;
+        y[i] = vector.y;
+        z[i] = vector.z;
+    }
+
+    void copyFrom(const VectorArrays &arrays, uint32_t count)
+    {
+        memcpy(x, arrays.x, count * sizeof(float));
+        memcpy(y, arrays.y, count * sizeof(float));
+        memcpy(z, arrays.z, count * sizeof(float));
+    }
+
+    VectorArrays arrays() const
+    {
+        VectorArrays arrays = { x, y, z };
+        return arrays;
+    }
+};
+
+// Plain data throughout, so buffers can be memcpy'd into rings and files.
+struct FrameBuffer {
+    int64_t id;
+    int64_t timestamp;
+    int64_t receivedNanos;
+    uint32_t handCount;
+    uint32_t pointableCount;
+    uint32_t gestureCount;
+    HandSnapshot hands[MaxHands];
+    int32_t pointableIds[MaxPointables];
+    int32_t pointableHandIds[MaxPointables];
+    uint8_t pointableHandIndices[MaxPointables];
+    VectorStorage tipPositions;
+    VectorStorage tipVelocities;
+    VectorStorage directions;
+    float widths[MaxPointables];
+    float lengths[MaxPointables];
+    uint8_t flags[MaxPointables];
+    GestureSnapshot gestures[MaxGestures];
+
+    FrameBuffer() : id(0), timestamp(0), receivedNanos(0), handCount(0), pointableCount(0), gestureCount(0) {}
+
+    void clear()
+    {
+        id = 0;
+        timestamp = 0;
+        receivedNanos = 0;
+        handCount = 0;
+        pointableCount = 0;
+        gestureCount = 0;
+    }
+
+    // Copies frame in, truncated to the buffer's capacities.
+    void copyFrom(const FrameSnapshot &frame)
+    {
+        id = frame.id;
+        timestamp = frame.timestamp;
+        receivedNanos = frame.receivedNanos;
+        handCount = frame.handCount < (uint32_t)MaxHands ? frame.handCount : (uint32_t)MaxHands;
+        pointableCount = frame.pointableCount < (uint32_t)MaxPointables ? frame.pointableCount : (uint32_t)MaxPointables;
+        gestureCount = frame.gestureCount < (uint32_t)MaxGestures ? frame.gestureCount : (uint32_t)MaxGestures;
+        const PointableArrays &pointables = frame.pointables;
+        const uint32_t n = pointableCount;
+        memcpy(hands, frame.hands, handCount * sizeof(HandSnapshot));
+        memcpy(pointableIds, pointables.ids, n * sizeof(int32_t));
+        memcpy(pointableHandIds, pointables.handIds, n * sizeof(int32_t));
+        memcpy(pointableHandIndices, pointables.handIndices, n * sizeof(uint8_t));
+        tipPositions.copyFrom(pointables.tipPositions, n);
+        tipVelocities.copyFrom(pointables.tipVelocities, n);
+        directions.copyFrom(pointables.directions, n);
+        memcpy(widths, pointables.widths, n * sizeof(float));
+        memcpy(lengths, pointables.lengths, n * sizeof(float));
+        memcpy(flags, pointables.flags, n * sizeof(uint8_t));
+        memcpy(gestures, frame.gestures, gestureCount * sizeof(GestureSnapshot));
+    }
+
+    FrameSnapshot snapshot() const
+    {
+        FrameSnapshot frame;
+        frame.id = id;
+        frame.timestamp = timestamp;
+        frame.receivedNanos = receivedNanos;
+        frame.handCount = handCount;
+        frame.hands = hands;
+        frame.pointableCount = pointableCount;
+        frame.pointables.ids = pointableIds;
+        frame.pointables.handIds = pointableHandIds;
+        frame.pointables.handIndices = pointableHandIndices;
+        frame.pointables.tipPositions = tipPositions.arrays();
+        frame.pointables.tipVelocities = tipVelocities.arrays();
+        frame.pointables.directions = directions.arrays();
+        frame.pointables.widths = widths;
+        frame.pointables.lengths = lengths;
+        frame.pointables.flags = flags;
+        frame.gestureCount = gestureCount;
+        frame.gestures = gestures;
+        return frame;
+    }
+};
+
+static_assert(std::is_trivially_copyable<FrameBuffer>::value, "FrameBuffer must stay plain data");
+
+}
+
+#endif
@@ -0,0 +1,30 @@
+//
+//  FrameSource.h
+//  OSXGestureControl
+//
+//  Copyright (c) 2013 Chris Willingham. All rights reserved.
+//
+
+#ifndef OSXGestureControl_FrameSource_h
+#define OSXGestureControl_FrameSource_h
+
+#include "FrameSnapshot.h"
+
+namespace GestureCore {
+
+// Anything that can hand frames to the detector: the live device, a
+// recording, a synthetic generator.
+class FrameSource
+{
+public:
+    virtual ~FrameSource() {}
+
+    // Fills frame with the next frame and returns true, or returns false
+    // when no frame is available. The data frame points to stays valid
+    // until the next call.
+    virtual bool nextFrame(FrameSnapshot &frame) = 0;
+};
+
+}
+
+#endif
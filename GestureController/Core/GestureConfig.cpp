@@ -0,0 +1,372 @@
+//
+//  GestureConfig.cpp
+//  OSXGestureControl
+//
+//  Copyright (c) 2013 Chris Willingham. All rights reserved.
+//
+
+#include "GestureConfig.h"
+
+#include <ctype.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <string>
+#include "TemplateRecognizer.h"
+
+namespace GestureCore {
+
+struct ConfigField {
+    const char *name;
+    ConfigType type;
+    size_t offset;
+    // Accepted values, inclusive. Wide enough for any sensible tuning;
+    // they're there so a typo can't reach the detector as NaN, a negative
+    // window or a number its type can't hold.
+    double min;
+    double max;
+};
+
+#define CONFIG_FIELD(name, type, member, min, max) { name, type, offsetof(GestureConfig, member), min, max }
+
+// A minute, in micros: longer than any window or refractory period needs.
+static const double MaxMicros = 60e6;
+
+// In ConfigKey order.
+static const ConfigField ConfigFields[ConfigKeyCount] = {
+    CONFIG_FIELD("swipe.verticalThreshold", ConfigTypeFloat, swipe.verticalThreshold, 1, 100000),
+    CONFIG_FIELD("swipe.horizontalThreshold", ConfigTypeFloat, swipe.horizontalThreshold, 1, 100000),
+    CONFIG_FIELD("swipe.interactionPlaneZ", ConfigTypeFloat, swipe.interactionPlaneZ, -1000, 1000),
+    CONFIG_FIELD("swipe.releaseRatio", ConfigTypeFloat, swipe.releaseRatio, 0, 1),
+    CONFIG_FIELD("swipe.refractoryUpMicros", ConfigTypeInt64, swipe.refractoryMicros[Up], 0, MaxMicros),
+    CONFIG_FIELD("swipe.refractoryDownMicros", ConfigTypeInt64, swipe.refractoryMicros[Down], 0, MaxMicros),
+    CONFIG_FIELD("swipe.refractoryLeftMicros", ConfigTypeInt64, swipe.refractoryMicros[Left], 0, MaxMicros),
+    CONFIG_FIELD("swipe.refractoryRightMicros", ConfigTypeInt64, swipe.refractoryMicros[Right], 0, MaxMicros),
+    CONFIG_FIELD("filter.kind", ConfigTypeFilterKind, filter.kind, FilterNone, FilterKalman),
+    CONFIG_FIELD("filter.minCutoff", ConfigTypeFloat, filter.minCutoff, 0.001, 1000),
+    CONFIG_FIELD("filter.beta", ConfigTypeFloat, filter.beta, 0, 100),
+    CONFIG_FIELD("filter.derivativeCutoff", ConfigTypeFloat, filter.derivativeCutoff, 0.001, 1000),
+    CONFIG_FIELD("filter.accelerationNoise", ConfigTypeFloat, filter.accelerationNoise, 0, 1e12),
+    CONFIG_FIELD("filter.positionNoise", ConfigTypeFloat, filter.positionNoise, 1e-6, 1e12),
+    CONFIG_FIELD("filter.velocityNoise", ConfigTypeFloat, filter.velocityNoise, 1e-6, 1e12),
+    CONFIG_FIELD("pinch.distance", ConfigTypeFloat, pinchDistance, 0, 1000),
+    CONFIG_FIELD("pinch.releaseDistance", ConfigTypeFloat, pinchReleaseDistance, 0, 1000),
+    CONFIG_FIELD("hold.maxSpeed", ConfigTypeFloat, holdMaxSpeed, 0, 100000),
+    CONFIG_FIELD("hold.micros", ConfigTypeInt64, holdMicros, 0, MaxMicros),
+    CONFIG_FIELD("zoom.ratio", ConfigTypeFloat, zoomRatio, 1.01, 100),
+    CONFIG_FIELD("zoom.minDistance", ConfigTypeFloat, zoomMinDistance, 0, 1000),
+    CONFIG_FIELD("scroll.fingers", ConfigTypeInt, scrollFingers, 1, MaxPointables),
+    CONFIG_FIELD("scroll.deadZone", ConfigTypeFloat, scrollDeadZone, 0, 100000),
+    CONFIG_FIELD("scroll.outputHz", ConfigTypeFloat, scroll.outputHz, 1, 1000),
+    CONFIG_FIELD("scroll.gain", ConfigTypeFloat, scroll.gain, -100, 100),
+    CONFIG_FIELD("scroll.friction", ConfigTypeFloat, scroll.friction, 0, 1000),
+    CONFIG_FIELD("scroll.stopSpeed", ConfigTypeFloat, scroll.stopSpeed, 0.1, 100000),
+    CONFIG_FIELD("scroll.maxGapMicros", ConfigTypeInt64, scroll.maxGapMicros, 0, MaxMicros),
+    CONFIG_FIELD("template.windowMicros", ConfigTypeInt64, templateWindowMicros, 0, MaxMicros),
+    CONFIG_FIELD("template.minPathLength", ConfigTypeFloat, templateMinPathLength, 0, 10000),
+    CONFIG_FIELD("template.minSpeed", ConfigTypeFloat, templateMinSpeed, 0, 100000),
+    CONFIG_FIELD("template.matchThreshold", ConfigTypeFloat, templateMatchThreshold, 0, 10),
+};
+
+#undef CONFIG_FIELD
+
+static const char *const FilterKindNames[] = { "none", "oneEuro", "kalman" };
+
+//////////////////////////////////////////////////////////////////////////
+//CONFIG
+GestureConfig::GestureConfig()
+    : version(0), pinchDistance(DefaultPinchDistance), pinchReleaseDistance(DefaultPinchReleaseDistance),
+      holdMaxSpeed(DefaultHoldMaxSpeed), holdMicros(DefaultHoldMicros), zoomRatio(DefaultZoomRatio),
+      zoomMinDistance(DefaultZoomMinDistance), scrollFingers(DefaultScrollFingers), scrollDeadZone(DefaultScrollDeadZone),
+      templateWindowMicros(DefaultTemplateWindowMicros), templateMinPathLength(DefaultTemplateMinPathLength),
+      templateMinSpeed(DefaultTemplateMinSpeed), templateMatchThreshold(DefaultTemplateMatchThreshold)
+{
+}
+
+ConfigKey GestureConfig::keyNamed(const char *name, size_t length)
+{
+    for (int key = 0; key < ConfigKeyCount; key++) {
+        const char *candidate = ConfigFields[key].name;
+        if (strncmp(candidate, name, length) == 0 && candidate[length] == '\0') {
+            return (ConfigKey)key;
+        }
+    }
+    return ConfigKeyCount;
+}
+
+const char *GestureConfig::keyName(ConfigKey key)
+{
+    return ConfigFields[key].name;
+}
+
+ConfigType GestureConfig::keyType(ConfigKey key)
+{
+    return ConfigFields[key].type;
+}
+
+double GestureConfig::value(ConfigKey key) const
+{
+    const char *field = (const char *)this + ConfigFields[key].offset;
+    switch (ConfigFields[key].type) {
+        case ConfigTypeFloat: return *(const float *)field;
+        case ConfigTypeInt: return *(const int *)field;
+        case ConfigTypeInt64: return (double)*(const int64_t *)field;
+        case ConfigTypeFilterKind: return *(const FilterKind *)field;
+    }
+    return 0;
+}
+
+bool GestureConfig::inRange(ConfigKey key, double value)
+{
+    // false for NaN too
+    return value >= ConfigFields[key].min && value <= ConfigFields[key].max;
+}
+
+void GestureConfig::setValue(ConfigKey key, double value)
+{
+    char *field = (char *)this + ConfigFields[key].offset;
+    // clamped, since converting an out of range double to an int is undefined
+    if (!inRange(key, value)) {
+        value = value < ConfigFields[key].min || value != value ? ConfigFields[key].min : ConfigFields[key].max;
+    }
+    switch (ConfigFields[key].type) {
+        case ConfigTypeFloat:
+            *(float *)field = (float)value;
+            break;
+        case ConfigTypeInt:
+            *(int *)field = (int)value;
+            break;
+        case ConfigTypeInt64:
+            *(int64_t *)field = (int64_t)value;
+            break;
+        case ConfigTypeFilterKind:
+            *(FilterKind *)field = (FilterKind)(int)value;
+            break;
+    }
+}
+
+static const char *skipSpace(const char *begin, const char *end)
+{
+    while (begin < end && isspace((unsigned char)*begin)) {
+        begin++;
+    }
+    return begin;
+}
+
+static const char *trimSpace(const char *begin, const char *end)
+{
+    while (end > begin && isspace((unsigned char)end[-1])) {
+        end--;
+    }
+    return end;
+}
+
+// Reads one value of type from [begin, end), which has no surrounding space.
+static bool parseValue(ConfigType type, const char *begin, const char *end, double &value)
+{
+    if (begin == end) {
+        return false;
+    }
+    if (type == ConfigTypeFilterKind) {
+        const size_t length = end - begin;
+        for (size_t kind = 0; kind < sizeof(FilterKindNames) / sizeof(FilterKindNames[0]); kind++) {
+            if (strncmp(FilterKindNames[kind], begin, length) == 0 && FilterKindNames[kind][length] == '\0') {
+                value = (double)kind;
+                return true;
+            }
+        }
+        return false;
+    }
+    // strtod stops at the end of the number, which must be the end of the line
+    char *parsed;
+    value = type == ConfigTypeFloat ? strtod(begin, &parsed) : (double)strtoll(begin, &parsed, 10);
+    return parsed == end;
+}
+
+bool GestureConfig::parse(const char *text, int *errorLine)
+{
+    for (int line = 1; *text != '\0'; line++) {
+        const char *lineEnd = strchr(text, '\n');
+        if (lineEnd == NULL) {
+            lineEnd = text + strlen(text);
+        }
+        const char *comment = (const char *)memchr(text, '#', lineEnd - text);
+        const char *begin = text;
+        const char *end = comment != NULL ? comment : lineEnd;
+        text = *lineEnd == '\n' ? lineEnd + 1 : lineEnd;
+
+        begin = skipSpace(begin, end);
+        end = trimSpace(begin, end);
+        if (begin == end) {
+            continue;
+        }
+        const char *equals = (const char *)memchr(begin, '=', end - begin);
+        double value;
+        ConfigKey key = ConfigKeyCount;
+        if (equals != NULL) {
+            key = keyNamed(begin, trimSpace(begin, equals) - begin);
+        }
+        if (key == ConfigKeyCount || !parseValue(keyType(key), skipSpace(equals + 1, end), end, value)
+            || !inRange(key, value)) {
+            if (errorLine != NULL) {
+                *errorLine = line;
+            }
+            return false;
+        }
+        setValue(key, value);
+    }
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+//STORE
+// _seen value of a slot with no reader
+static const uint64_t NoReader = UINT64_MAX;
+
+ConfigStore::ConfigStore(const GestureConfig &defaults) : _defaults(defaults), _version(0)
+{
+    GestureConfig *initial = new GestureConfig(defaults);
+    initial->version = 0;
+    _current.store(initial);
+    for (int i = 0; i < MaxReaders; i++) {
+        _seen[i].store(NoReader);
+    }
+}
+
+ConfigStore::~ConfigStore()
+{
+    delete _current.load();
+    for (size_t i = 0; i < _retired.size(); i++) {
+        delete _retired[i];
+    }
+}
+
+void ConfigStore::publish(const GestureConfig &config)
+{
+    // built in full before it's visible, and never written after
+    GestureConfig *next = new GestureConfig(config);
+    std::lock_guard<std::mutex> lock(_lock);
+    next->version = _version.load(std::memory_order_relaxed) + 1;
+    _retired.push_back(_current.exchange(next));
+    _version.store(next->version, std::memory_order_release);
+    reclaim();
+}
+
+void ConfigStore::reclaim()
+{
+    // A reader announces a version only after it has stopped using older
+    // ones, and it only ever moves to the current one, so anything older
+    // than every announced version is unreachable.
+    uint64_t oldest = NoReader;
+    for (int i = 0; i < MaxReaders; i++) {
+        oldest = std::min(oldest, _seen[i].load());
+    }
+    size_t kept = 0;
+    for (size_t i = 0; i < _retired.size(); i++) {
+        if (_retired[i]->version < oldest) {
+            delete _retired[i];
+        } else {
+            _retired[kept++] = _retired[i];
+        }
+    }
+    _retired.resize(kept);
+}
+
+bool ConfigStore::load(const char *text, int *errorLine)
+{
+    GestureConfig config = _defaults;
+    if (!config.parse(text, errorLine)) {
+        return false;
+    }
+    publish(config);
+    return true;
+}
+
+bool ConfigStore::loadFile(const char *path, int *errorLine)
+{
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        if (errorLine != NULL) {
+            *errorLine = 0;
+        }
+        return false;
+    }
+    std::string text;
+    char chunk[4096];
+    size_t read;
+    while ((read = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        text.append(chunk, read);
+    }
+    const bool failed = ferror(file) != 0;
+    fclose(file);
+    if (failed) {
+        if (errorLine != NULL) {
+            *errorLine = 0;
+        }
+        return false;
+    }
+    return load(text.c_str(), errorLine);
+}
+
+GestureConfig ConfigStore::current() const
+{
+    // writers only free versions while holding the lock
+    std::lock_guard<std::mutex> lock(_lock);
+    return *_current.load();
+}
+
+//////////////////////////////////////////////////////////////////////////
+//READER
+ConfigReader::ConfigReader() : _store(NULL), _slot(-1), _config(NULL)
+{
+}
+
+ConfigReader::~ConfigReader()
+{
+    close();
+}
+
+bool ConfigReader::open(ConfigStore &store)
+{
+    close();
+    std::lock_guard<std::mutex> lock(store._lock);
+    for (int i = 0; i < ConfigStore::MaxReaders; i++) {
+        if (store._seen[i].load() == NoReader) {
+            _config = store._current.load();
+            store._seen[i].store(_config->version);
+            _store = &store;
+            _slot = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+void ConfigReader::close()
+{
+    if (_store == NULL) {
+        return;
+    }
+    // whatever this reader held is reclaimed on the next publish
+    _store->_seen[_slot].store(NoReader);
+    _store = NULL;
+    _slot = -1;
+    _config = NULL;
+}
+
+bool ConfigReader::update()
+{
+    const GestureConfig *latest = _store->_current.load(std::memory_order_acquire);
+    if (latest == _config) {
+        return false;
+    }
+    // latest is at least as new as the version announced so far, so it
+    // can't be freed between the load and this store
+    _config = latest;
+    _store->_seen[_slot].store(latest->version);
+    return true;
+}
+
+}
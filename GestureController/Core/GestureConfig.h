@@ -0,0 +1,195 @@
+//
+//  GestureConfig.h
+//  OSXGestureControl
+//
+//  Copyright (c) 2013 Chris Willingham. All rights reserved.
+//
+//  Every threshold the detector reads, gathered into one flat struct so the
+//  per-frame path reads a field rather than asking a config store by name.
+//  Settings also have interned ids (ConfigKey) for code that sets or reads
+//  them generically; names are only looked at when text is parsed.
+//
+//  ConfigStore holds the live config for hot-reload, RCU style. Each load
+//  publishes a whole new immutable config through an atomic pointer, so a
+//  reader sees one complete version or the next, never a mix, and reading
+//  takes no lock. Old versions are freed by the publishing thread once every
+//  ConfigReader has moved past them.
+//
+
+#ifndef OSXGestureControl_GestureConfig_h
+#define OSXGestureControl_GestureConfig_h
+
+#include <stdint.h>
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include "PointableFilter.h"
+#include "Recognizers.h"
+#include "ScrollEngine.h"
+
+namespace GestureCore {
+
+enum ConfigKey {
+    ConfigSwipeVerticalThreshold,
+    ConfigSwipeHorizontalThreshold,
+    ConfigSwipeInteractionPlaneZ,
+    ConfigSwipeReleaseRatio,
+    ConfigSwipeRefractoryUp,
+    ConfigSwipeRefractoryDown,
+    ConfigSwipeRefractoryLeft,
+    ConfigSwipeRefractoryRight,
+    ConfigFilterKind,
+    ConfigFilterMinCutoff,
+    ConfigFilterBeta,
+    ConfigFilterDerivativeCutoff,
+    ConfigFilterAccelerationNoise,
+    ConfigFilterPositionNoise,
+    ConfigFilterVelocityNoise,
+    ConfigPinchDistance,
+    ConfigPinchReleaseDistance,
+    ConfigHoldMaxSpeed,
+    ConfigHoldMicros,
+    ConfigZoomRatio,
+    ConfigZoomMinDistance,
+    ConfigScrollFingers,
+    ConfigScrollDeadZone,
+    ConfigScrollOutputHz,
+    ConfigScrollGain,
+    ConfigScrollFriction,
+    ConfigScrollStopSpeed,
+    ConfigScrollMaxGapMicros,
+    ConfigTemplateWindowMicros,
+    ConfigTemplateMinPathLength,
+    ConfigTemplateMinSpeed,
+    ConfigTemplateMatchThreshold,
+    ConfigKeyCount
+};
+
+enum ConfigType {
+    ConfigTypeFloat,
+    ConfigTypeInt,
+    ConfigTypeInt64,
+    ConfigTypeFilterKind    // "none", "oneEuro" or "kalman"
+};
+
+struct GestureConfig {
+    uint64_t version;   // set by ConfigStore, 0 for a config built by hand
+    DetectorParams swipe;
+    FilterParams filter;
+    float pinchDistance;
+    float pinchReleaseDistance;
+    float holdMaxSpeed;
+    int64_t holdMicros;
+    float zoomRatio;
+    float zoomMinDistance;
+    int scrollFingers;
+    float scrollDeadZone;
+    ScrollParams scroll;
+    int64_t templateWindowMicros;
+    float templateMinPathLength;
+    float templateMinSpeed;
+    float templateMatchThreshold;
+
+    // The recognizers' own defaults, as a new GestureDetector has them.
+    GestureConfig();
+
+    // Interned ids. keyNamed returns ConfigKeyCount for an unknown name.
+    static ConfigKey keyNamed(const char *name, size_t length);
+    static const char *keyName(ConfigKey key);
+    static ConfigType keyType(ConfigKey key);
+
+    // Whether value is one the setting accepts; NaN and infinities never are.
+    static bool inRange(ConfigKey key, double value);
+
+    // Generic access by id, converting to and from the setting's type.
+    // setValue clamps a value out of range (NaN to the minimum).
+    double value(ConfigKey key) const;
+    void setValue(ConfigKey key, double value);
+
+    // Applies "name = value" lines over this config. Blank lines and
+    // anything after '#' are ignored. Stops at the first unknown name or
+    // bad or out of range value and returns false with its 1-based line in
+    // errorLine, leaving the lines before it applied.
+    bool parse(const char *text, int *errorLine = NULL);
+};
+
+class ConfigReader;
+
+class ConfigStore
+{
+public:
+    enum { MaxReaders = 4 };
+
+    // Loads apply over defaults, so a setting removed from the file goes
+    // back to its default on the next load.
+    explicit ConfigStore(const GestureConfig &defaults);
+    // Every reader must be closed first.
+    ~ConfigStore();
+
+    // Publishes config as the next version. Publishing (and loading) takes
+    // a lock among writers only.
+    void publish(const GestureConfig &config);
+
+    // Parses text or a file over the defaults and publishes the result.
+    // Publishes nothing and returns false if the text doesn't parse or the
+    // file can't be read (errorLine 0).
+    bool load(const char *text, int *errorLine = NULL);
+    bool loadFile(const char *path, int *errorLine = NULL);
+
+    uint64_t version() const { return _version.load(std::memory_order_acquire); }
+
+    // A copy of the current config, for code off the hot path.
+    GestureConfig current() const;
+
+private:
+    friend class ConfigReader;
+
+    ConfigStore(const ConfigStore &);
+    ConfigStore &operator=(const ConfigStore &);
+
+    // frees retired versions no reader can still be holding; needs _lock
+    void reclaim();
+
+    mutable std::mutex _lock;
+    const GestureConfig _defaults;
+    std::atomic<const GestureConfig *> _current;
+    std::atomic<uint64_t> _version;
+    // version each open reader last moved to, NoReader for a free slot
+    std::atomic<uint64_t> _seen[MaxReaders];
+    std::vector<const GestureConfig *> _retired;
+};
+
+// One thread's view of a ConfigStore. config() is a plain load of a
+// pointer the reader already holds, and update() one atomic load plus, when
+// there's a new version, one store, so neither can block on a writer.
+class ConfigReader
+{
+public:
+    ConfigReader();
+    ~ConfigReader();
+
+    // Starts reading store's current config. Returns false if store already
+    // has MaxReaders readers open.
+    bool open(ConfigStore &store);
+    void close();
+    bool isOpen() const { return _store != NULL; }
+
+    // The version last moved to. It stays valid, and unchanged, until the
+    // next update() or close().
+    const GestureConfig &config() const { return *_config; }
+
+    // Moves to the newest version. Returns true if there was one.
+    bool update();
+
+private:
+    ConfigReader(const ConfigReader &);
+    ConfigReader &operator=(const ConfigReader &);
+
+    ConfigStore *_store;
+    int _slot;
+    const GestureConfig *_config;
+};
+
+}
+
+#endif
@@ -0,0 +1,203 @@
+//
+//  GestureDetector.cpp
+//  OSXGestureControl
+//
+//  Copyright (c) 2013 Chris Willingham. All rights reserved.
+//
+
+#include "GestureDetector.h"
+
+namespace GestureCore {
+
+GestureDetector::GestureDetector()
+    : _handler(NULL), _lastFrameId(-1), _velocitySwipe(_swipeGate), _sdkSwipe(_swipeGate), _templates(_swipeGate),
+      _recognizerCount(0), _activeCount(0), _engagedCount(0)
+{
+    addRecognizer(&_velocitySwipe, true);
+    addRecognizer(&_sdkSwipe, false);
+    addRecognizer(&_circle, false);
+    addRecognizer(&_keyTap, false);
+    addRecognizer(&_pinch, false);
+    addRecognizer(&_hold, false);
+    addRecognizer(&_twoHandZoom, false);
+    addRecognizer(&_scroll, false);
+    addRecognizer(&_templates, false);
+}
+
+void GestureDetector::setParams(const DetectorParams &params)
+{
+    _velocitySwipe.setParams(params);
+    _swipeGate.setRefractory(params.refractoryMicros);
+}
+
+void GestureDetector::setConfig(const GestureConfig &config)
+{
+    setParams(config.swipe);
+    _filter.setParams(config.filter);
+    _pinch.pinchDistance = config.pinchDistance;
+    _pinch.releaseDistance = config.pinchReleaseDistance;
+    _hold.maxSpeed = config.holdMaxSpeed;
+    _hold.holdMicros = config.holdMicros;
+    _twoHandZoom.zoomRatio = config.zoomRatio;
+    _twoHandZoom.minDistance = config.zoomMinDistance;
+    _scroll.fingers = config.scrollFingers;
+    _scroll.deadZone = config.scrollDeadZone;
+    _scroll.setParams(config.scroll);
+    _templates.windowMicros = config.templateWindowMicros;
+    _templates.minPathLength = config.templateMinPathLength;
+    _templates.minSpeed = config.templateMinSpeed;
+    _templates.matchThreshold = config.templateMatchThreshold;
+}
+
+GestureConfig GestureDetector::config() const
+{
+    GestureConfig config;
+    config.swipe = params();
+    config.filter = _filter.params();
+    config.pinchDistance = _pinch.pinchDistance;
+    config.pinchReleaseDistance = _pinch.releaseDistance;
+    config.holdMaxSpeed = _hold.maxSpeed;
+    config.holdMicros = _hold.holdMicros;
+    config.zoomRatio = _twoHandZoom.zoomRatio;
+    config.zoomMinDistance = _twoHandZoom.minDistance;
+    config.scrollFingers = _scroll.fingers;
+    config.scrollDeadZone = _scroll.deadZone;
+    config.scroll = _scroll.params();
+    config.templateWindowMicros = _templates.windowMicros;
+    config.templateMinPathLength = _templates.minPathLength;
+    config.templateMinSpeed = _templates.minSpeed;
+    config.templateMatchThreshold = _templates.matchThreshold;
+    return config;
+}
+
+bool GestureDetector::addRecognizer(GestureRecognizer *recognizer, bool enabled)
+{
+    if (_recognizerCount == MaxRecognizers || indexOf(recognizer) >= 0) {
+        return false;
+    }
+    _recognizers[_recognizerCount] = recognizer;
+    _inputs[_recognizerCount] = recognizer->inputs();
+    _enabled[_recognizerCount] = enabled;
+    _engaged[_recognizerCount] = false;
+    _recognizerCount++;
+    updateActive();
+    return true;
+}
+
+void GestureDetector::setEnabled(GestureRecognizer *recognizer, bool enabled)
+{
+    const int index = indexOf(recognizer);
+    if (index < 0 || _enabled[index] == enabled) {
+        return;
+    }
+    _enabled[index] = enabled;
+    // start from a clean slate either way
+    recognizer->reset();
+    _engaged[index] = false;
+    updateActive();
+}
+
+bool GestureDetector::isEnabled(const GestureRecognizer *recognizer) const
+{
+    const int index = indexOf(recognizer);
+    return index >= 0 && _enabled[index];
+}
+
+int GestureDetector::indexOf(const GestureRecognizer *recognizer) const
+{
+    for (size_t i = 0; i < _recognizerCount; i++) {
+        if (_recognizers[i] == recognizer) {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+void GestureDetector::updateActive()
+{
+    _activeCount = 0;
+    _engagedCount = 0;
+    for (size_t i = 0; i < _recognizerCount; i++) {
+        if (_enabled[i]) {
+            _active[_activeCount++] = (uint8_t)i;
+            _engagedCount += _engaged[i];
+        }
+    }
+}
+
+void GestureDetector::reset()
+{
+    _swipeGate.reset();
+    _lastFrameId = -1;
+    _history.clear();
+    _filter.reset();
+    for (size_t i = 0; i < _recognizerCount; i++) {
+        _recognizers[i]->reset();
+        _engaged[i] = false;
+    }
+    _engagedCount = 0;
+}
+
+void GestureDetector::processFrame(const FrameSnapshot &raw)
+{
+    _lastFrameId = raw.id;
+    _history.push(raw);
+    const FrameSnapshot &frame = _filter.apply(raw);
+
+    unsigned contents = 0;
+    if (frame.handCount > 0) {
+        contents |= FrameHasHands;
+    }
+    if (frame.gestureCount > 0) {
+        contents |= FrameHasSdkGestures;
+    }
+    for (uint32_t i = 0; i < frame.pointableCount; i++) {
+        if (frame.pointables.flags[i] & PointableIsFinger) {
+            contents |= FrameHasFingers;
+            break;
+        }
+    }
+    // nothing in view and nobody midway through a gesture
+    if (contents == 0 && _engagedCount == 0) {
+        return;
+    }
+
+    GestureHandler &handler = _handler != NULL ? *_handler : _discard;
+    for (size_t a = 0; a < _activeCount; a++) {
+        const uint8_t i = _active[a];
+        if ((_inputs[i] & contents) == 0 && !_engaged[i]) {
+            continue;
+        }
+        const bool engaged = _recognizers[i]->processFrame(frame, handler);
+        if (engaged != _engaged[i]) {
+            _engaged[i] = engaged;
+            _engagedCount += engaged ? 1 : -1;
+        }
+    }
+}
+
+size_t GestureDetector::processFrames(const FrameSnapshot *frames, size_t count)
+{
+    // ids rise through a span, so only a prefix can have been seen already
+    size_t first = 0;
+    while (first < count && frames[first].id <= _lastFrameId) {
+        first++;
+    }
+    for (size_t i = first; i < count; i++) {
+        processFrame(frames[i]);
+    }
+    return count - first;
+}
+
+size_t GestureDetector::run(FrameSource &source)
+{
+    size_t frames = 0;
+    FrameSnapshot frame;
+    while (source.nextFrame(frame)) {
+        processFrame(frame);
+        frames++;
+    }
+    return frames;
+}
+
+}
@@ -0,0 +1,140 @@
+//
+//  GestureDetector.h
+//  OSXGestureControl
+//
+//  Copyright (c) 2013 Chris Willingham. All rights reserved.
+//
+//  Portable gesture detection. Has no dependency on the Leap library or
+//  Objective-C so it can be driven by any FrameSource.
+//
+//  The detector is a registry of GestureRecognizers run in one pass over
+//  each frame. What the frame contains is worked out once up front and
+//  recognizers without matching inputs are skipped, so a disabled or idle
+//  recognizer costs nothing.
+//
+
+#ifndef OSXGestureControl_GestureDetector_h
+#define OSXGestureControl_GestureDetector_h
+
+#include <stddef.h>
+#include "FrameHistory.h"
+#include "FrameSnapshot.h"
+#include "FrameSource.h"
+#include "GestureConfig.h"
+#include "GestureRecognizer.h"
+#include "PointableFilter.h"
+#include "Recognizers.h"
+#include "ScrollEngine.h"
+#include "TemplateRecognizer.h"
+
+namespace GestureCore {
+
+class GestureDetector
+{
+public:
+    enum { MaxRecognizers = 16 };
+
+    GestureDetector();
+
+    void setHandler(GestureHandler *handler) { _handler = handler; }
+
+    void setParams(const DetectorParams &params);
+    const DetectorParams &params() const { return _velocitySwipe.params(); }
+
+    // Every threshold at once: the swipe params, the filter and the other
+    // built-in recognizers' settings. config().version is always 0.
+    void setConfig(const GestureConfig &config);
+    GestureConfig config() const;
+
+    // Registers a recognizer the caller keeps alive for the detector's
+    // lifetime. Returns false once MaxRecognizers are registered.
+    bool addRecognizer(GestureRecognizer *recognizer, bool enabled = true);
+    void setEnabled(GestureRecognizer *recognizer, bool enabled);
+    bool isEnabled(const GestureRecognizer *recognizer) const;
+
+    // The built-in recognizers, registered by the constructor. Only the
+    // velocity swipe starts enabled.
+    VelocitySwipeRecognizer &velocitySwipe() { return _velocitySwipe; }
+    SdkSwipeRecognizer &sdkSwipe() { return _sdkSwipe; }
+    CircleRecognizer &circle() { return _circle; }
+    KeyTapRecognizer &keyTap() { return _keyTap; }
+    PinchRecognizer &pinch() { return _pinch; }
+    HoldRecognizer &hold() { return _hold; }
+    TwoHandZoomRecognizer &twoHandZoom() { return _twoHandZoom; }
+    ScrollRecognizer &scroll() { return _scroll; }
+    TemplateRecognizer &templates() { return _templates; }
+
+    // Smoothing applied to tip velocities before any recognizer sees them.
+    // Off (FilterNone) by default.
+    void setFilter(const FilterParams &params) { _filter.setParams(params); }
+    const FilterParams &filter() const { return _filter.params(); }
+
+    // Keeps the last frames frames processed for lookback; 0 (the default)
+    // keeps none. The ring is allocated here, never per frame.
+    void setHistoryLength(size_t frames) { _history.setCapacity(frames); }
+    const FrameHistory &history() const { return _history; }
+
+    // Runs detection over a single frame.
+    void processFrame(const FrameSnapshot &frame);
+
+    // Runs detection over count consecutive frames, oldest first, in one
+    // call. Frames at or before the last one processed are skipped, so a
+    // catch-up span that overlaps what was already seen (everything since
+    // some earlier frame, say) only detects each frame once. Returns the
+    // number of frames processed. Call reset() before switching to a
+    // source whose frame ids start over.
+    size_t processFrames(const FrameSnapshot *frames, size_t count);
+
+    // Id of the last frame processed, -1 before the first or after reset().
+    int64_t lastFrameId() const { return _lastFrameId; }
+
+    // Pulls frames from source until it runs dry, returns the number processed.
+    size_t run(FrameSource &source);
+
+    void reset();
+
+private:
+    GestureDetector(const GestureDetector &);
+    GestureDetector &operator=(const GestureDetector &);
+
+    class DiscardingHandler : public GestureHandler
+    {
+    public:
+        virtual void onGesture(const GestureEvent &) {}
+    };
+
+    int indexOf(const GestureRecognizer *recognizer) const;
+    void updateActive();
+
+    GestureHandler *_handler;
+    DiscardingHandler _discard;
+    int64_t _lastFrameId;
+    FrameHistory _history;
+    PointableFilter _filter;
+
+    SwipeGate _swipeGate;
+    VelocitySwipeRecognizer _velocitySwipe;
+    SdkSwipeRecognizer _sdkSwipe;
+    CircleRecognizer _circle;
+    KeyTapRecognizer _keyTap;
+    PinchRecognizer _pinch;
+    HoldRecognizer _hold;
+    TwoHandZoomRecognizer _twoHandZoom;
+    ScrollRecognizer _scroll;
+    TemplateRecognizer _templates;
+
+    // every registered recognizer, in registration order
+    GestureRecognizer *_recognizers[MaxRecognizers];
+    unsigned _inputs[MaxRecognizers];
+    bool _enabled[MaxRecognizers];
+    bool _engaged[MaxRecognizers];
+    size_t _recognizerCount;
+    // indices of the enabled ones, which is all processFrame walks
+    uint8_t _active[MaxRecognizers];
+    size_t _activeCount;
+    size_t _engagedCount;
+};
+
+}
+
+#endif
@@ -0,0 +1,74 @@
+//
+//  GestureRecognizer.h
+//  OSXGestureControl
+//
+//  Copyright (c) 2013 Chris Willingham. All rights reserved.
+//
+//  Interface for the recognizers GestureDetector runs over every frame.
+//  Each recognizer looks at the shared FrameSnapshot and reports what it
+//  finds to a GestureHandler; it never sees the Leap library.
+//
+
+#ifndef OSXGestureControl_GestureRecognizer_h
+#define OSXGestureControl_GestureRecognizer_h
+
+#include "FrameSnapshot.h"
+#include "GestureTypes.h"
+
+namespace GestureCore {
+
+// direction is only meaningful for swipes (and circles: Right is clockwise,
+// Left counterclockwise; zooms: Up spreads, Down closes). position and
+// magnitude depend on the type: circle center and turns, tap position,
+// pinch point and finger gap in mm, palm position and seconds held, the
+// point between the palms and the scale since the last zoom step.
+struct GestureEvent {
+    GestureType type;
+    Direction direction;
+    int fingers;
+    Leap::Vector avgVelocity;
+    Leap::Vector position;
+    float magnitude;
+    int64_t frameId;
+    int64_t timestamp;
+    int64_t receivedNanos;  // the frame's, for LatencyTrace
+
+    GestureEvent() : type(SWIPE_GESTURE), direction(Up), fingers(0), magnitude(0), frameId(0), timestamp(0), receivedNanos(0) {}
+    GestureEvent(GestureType type, const FrameSnapshot &frame)
+        : type(type), direction(Up), fingers(0), magnitude(0), frameId(frame.id), timestamp(frame.timestamp),
+          receivedNanos(frame.receivedNanos) {}
+};
+
+class GestureHandler
+{
+public:
+    virtual ~GestureHandler() {}
+    virtual void onGesture(const GestureEvent &event) = 0;
+};
+
+// What a frame contains, worked out once per frame by GestureDetector.
+enum FrameContents {
+    FrameHasFingers = 1 << 0,
+    FrameHasHands = 1 << 1,
+    FrameHasSdkGestures = 1 << 2
+};
+
+class GestureRecognizer
+{
+public:
+    virtual ~GestureRecognizer() {}
+
+    // FrameContents bits the recognizer works from. Frames containing none
+    // of them are skipped. Read once at registration, so it must not change.
+    virtual unsigned inputs() const = 0;
+
+    // Returns true while the recognizer is partway through a gesture, which
+    // keeps it getting frames that lack its inputs (e.g. to see the hand go).
+    virtual bool processFrame(const FrameSnapshot &frame, GestureHandler &handler) = 0;
+
+    virtual void reset() = 0;
+};
+
+}
+
+#endif
@@ -0,0 +1,31 @@
+//
+//  GestureTypes.h
+//  OSXGestureControl
+//
+//  Copyright (c) 2013 Chris Willingham. All rights reserved.
+//
+//  Plain C enums shared by the Objective-C Gesture class and the C++
+//  detection core.
+//
+
+#ifndef OSXGestureControl_GestureTypes_h
+#define OSXGestureControl_GestureTypes_h
+
+typedef enum {
+    Up,
+    Down,
+    Left,
+    Right
+} Direction;
+
+typedef enum {
+    SCROLL_GESTURE,
+    SWIPE_GESTURE,
+    CIRCLE_GESTURE,
+    KEY_TAP_GESTURE,
+    PINCH_GESTURE,
+    HOLD_GESTURE,
+    ZOOM_GESTURE
+}GestureType;
+
+#endif
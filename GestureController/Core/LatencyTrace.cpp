@@ -0,0 +1,140 @@
+//
+//  LatencyTrace.cpp
+//  OSXGestureControl
+//
+//  Copyright (c) 2013 Chris Willingham. All rights reserved.
+//
+
+#include "LatencyTrace.h"
+
+#include <stdio.h>
+#include <algorithm>
+#include <chrono>
+
+namespace GestureCore {
+
+//////////////////////////////////////////////////////////////////////////
+//HISTOGRAM
+int LatencyHistogram::indexOf(uint64_t nanos)
+{
+    if (nanos < SubBuckets) {
+        return (int)nanos;
+    }
+    int shift = 63 - __builtin_clzll(nanos) - (SubBucketBits - 1);
+    if (shift > MaxShift) {
+        return BucketCount - 1;
+    }
+    // nanos >> shift is in [HalfSubBuckets, SubBuckets)
+    return shift * HalfSubBuckets + (int)(nanos >> shift);
+}
+
+int64_t LatencyHistogram::highestIn(int index)
+{
+    if (index < SubBuckets) {
+        return index;
+    }
+    const int shift = index / HalfSubBuckets - 1;
+    const int64_t subBucket = index - shift * HalfSubBuckets;
+    return ((subBucket + 1) << shift) - 1;
+}
+
+void LatencyHistogram::record(int64_t nanos)
+{
+    if (nanos < 0) {
+        nanos = 0;
+    }
+    _counts[indexOf((uint64_t)nanos)].fetch_add(1, std::memory_order_relaxed);
+    _total.fetch_add(1, std::memory_order_relaxed);
+    int64_t max = _max.load(std::memory_order_relaxed);
+    while (nanos > max && !_max.compare_exchange_weak(max, nanos, std::memory_order_relaxed)) {
+    }
+}
+
+int64_t LatencyHistogram::percentile(double quantile) const
+{
+    // count from the buckets themselves so the walk is self-consistent
+    // while other threads keep recording
+    uint64_t counts[BucketCount];
+    uint64_t total = 0;
+    for (int i = 0; i < BucketCount; i++) {
+        counts[i] = _counts[i].load(std::memory_order_relaxed);
+        total += counts[i];
+    }
+    if (total == 0) {
+        return 0;
+    }
+    uint64_t rank = (uint64_t)(quantile * total + 0.5);
+    rank = rank < 1 ? 1 : rank > total ? total : rank;
+    // the last bucket is open ended, and no bucket edge is worth reporting
+    // past the largest sample
+    const int64_t largest = max();
+    uint64_t seen = 0;
+    for (int i = 0; i < BucketCount - 1; i++) {
+        seen += counts[i];
+        if (seen >= rank) {
+            return std::min(highestIn(i), largest);
+        }
+    }
+    return largest;
+}
+
+void LatencyHistogram::reset()
+{
+    for (int i = 0; i < BucketCount; i++) {
+        _counts[i].store(0, std::memory_order_relaxed);
+    }
+    _total.store(0, std::memory_order_relaxed);
+    _max.store(0, std::memory_order_relaxed);
+}
+
+//////////////////////////////////////////////////////////////////////////
+//TRACE
+LatencyTrace &LatencyTrace::shared()
+{
+    static LatencyTrace trace;
+    return trace;
+}
+
+int64_t LatencyTrace::nowNanos()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+const char *LatencyTrace::stageName(TraceStage stage)
+{
+    switch (stage) {
+        case TraceCapture: return "capture";
+        case TraceQueue: return "queue";
+        case TraceDetect: return "detect";
+        case TraceDispatch: return "dispatch";
+        case TraceAction: return "action";
+        case TraceEndToEnd: return "end-to-end";
+        case TraceStageCount: break;
+    }
+    return "?";
+}
+
+std::string LatencyTrace::report() const
+{
+    std::string report;
+    char line[160];
+    snprintf(line, sizeof(line), "%-12s %10s %10s %10s %10s %10s\n", "stage (us)", "count", "p50", "p99", "p99.9", "max");
+    report += line;
+    for (int i = 0; i < TraceStageCount; i++) {
+        const LatencyHistogram &histogram = _histograms[i];
+        snprintf(line, sizeof(line), "%-12s %10llu %10.1f %10.1f %10.1f %10.1f\n", stageName((TraceStage)i),
+                 (unsigned long long)histogram.count(), histogram.percentile(0.5) / 1e3,
+                 histogram.percentile(0.99) / 1e3, histogram.percentile(0.999) / 1e3, histogram.max() / 1e3);
+        report += line;
+    }
+    return report;
+}
+
+void LatencyTrace::reset()
+{
+    for (int i = 0; i < TraceStageCount; i++) {
+        _histograms[i].reset();
+    }
+}
+
+}
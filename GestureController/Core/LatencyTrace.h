@@ -0,0 +1,133 @@
+//
+//  LatencyTrace.h
+//  OSXGestureControl
+//
+//  Copyright (c) 2013 Chris Willingham. All rights reserved.
+//
+//  Where the time goes between the Leap callback and the posted event.
+//  Each stage of the pipeline takes monotonic clock readings and records
+//  the difference into a histogram for that stage; report() summarizes
+//  them as percentiles.
+//
+//  Tracing starts off. While it's off a tracepoint is one relaxed load and
+//  the frame carries a zero start time, which every later stage skips.
+//  Building with GESTURE_TRACE=0 removes the tracepoints altogether.
+//
+
+#ifndef OSXGestureControl_LatencyTrace_h
+#define OSXGestureControl_LatencyTrace_h
+
+#include <stdint.h>
+#include <atomic>
+#include <string>
+
+#ifndef GESTURE_TRACE
+#define GESTURE_TRACE 1
+#endif
+
+namespace GestureCore {
+
+enum TraceStage {
+    TraceCapture,   // Leap callback until the frame is in the ring
+    TraceQueue,     // Leap callback until the detector thread takes the frame
+    TraceDetect,    // GestureDetector::processFrame
+    TraceDispatch,  // gesture found until the main thread callback runs
+    TraceAction,    // action queued until its first event is posted
+    TraceEndToEnd,  // Leap callback until the first event is posted
+    TraceStageCount
+};
+
+// Log-linear buckets in the style of HdrHistogram: 64 linear sub-buckets
+// per power of two, so any value is reported within 1/64 of itself, from
+// 1 ns up to a couple of minutes. Recording is a couple of relaxed atomic
+// adds, safe from any thread while another reads.
+class LatencyHistogram
+{
+public:
+    LatencyHistogram() { reset(); }
+
+    void record(int64_t nanos);
+
+    uint64_t count() const { return _total.load(std::memory_order_relaxed); }
+    int64_t max() const { return _max.load(std::memory_order_relaxed); }
+
+    // Upper edge of the bucket holding the quantile (0 to 1), 0 if empty.
+    int64_t percentile(double quantile) const;
+
+    // Samples recorded during a reset may survive it.
+    void reset();
+
+private:
+    enum {
+        SubBucketBits = 7,
+        SubBuckets = 1 << SubBucketBits,
+        HalfSubBuckets = SubBuckets / 2,
+        MaxShift = 30,
+        BucketCount = (MaxShift + 2) * HalfSubBuckets
+    };
+
+    static int indexOf(uint64_t nanos);
+    static int64_t highestIn(int index);
+
+    std::atomic<uint64_t> _counts[BucketCount];
+    std::atomic<uint64_t> _total;
+    std::atomic<int64_t> _max;
+};
+
+class LatencyTrace
+{
+public:
+    // The one trace every stage records into.
+    static LatencyTrace &shared();
+
+    static int64_t nowNanos();
+    static const char *stageName(TraceStage stage);
+
+    bool enabled() const
+    {
+#if GESTURE_TRACE
+        return _enabled.load(std::memory_order_relaxed);
+#else
+        return false;
+#endif
+    }
+    void setEnabled(bool enabled) { _enabled.store(enabled, std::memory_order_relaxed); }
+
+    // Start time for a stage, or 0 while tracing is off.
+    int64_t begin() const { return enabled() ? nowNanos() : 0; }
+
+    // Records the time since start, unless start is 0 (not traced).
+    void end(TraceStage stage, int64_t startNanos)
+    {
+        if (startNanos != 0 && enabled()) {
+            _histograms[stage].record(nowNanos() - startNanos);
+        }
+    }
+
+    void record(TraceStage stage, int64_t nanos)
+    {
+        if (enabled()) {
+            _histograms[stage].record(nanos);
+        }
+    }
+
+    const LatencyHistogram &histogram(TraceStage stage) const { return _histograms[stage]; }
+
+    // One line per stage: sample count then p50, p99, p99.9 and max in
+    // microseconds.
+    std::string report() const;
+
+    void reset();
+
+private:
+    LatencyTrace() : _enabled(false) {}
+    LatencyTrace(const LatencyTrace &);
+    LatencyTrace &operator=(const LatencyTrace &);
+
+    std::atomic<bool> _enabled;
+    LatencyHistogram _histograms[TraceStageCount];
+};
+
+}
+
+#endif
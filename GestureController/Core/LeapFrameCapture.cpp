@@ -0,0 +1,188 @@
+//
+//  LeapFrameCapture.cpp
+//  OSXGestureControl
+//
+//  Copyright (c) 2013 Chris Willingham. All rights reserved.
+//
+
+#include "LeapFrameCapture.h"
+#include "../include/Leap.h"
+
+namespace GestureCore {
+
+static void captureGesture(const Leap::Gesture &leapGesture, GestureSnapshot &gesture)
+{
+    gesture.id = leapGesture.id();
+    gesture.type = leapGesture.type();
+    gesture.state = leapGesture.state();
+    gesture.duration = leapGesture.duration();
+    gesture.pointableId = -1;
+    gesture.position = Float3::fromVector(Leap::Vector());
+    gesture.direction = Float3::fromVector(Leap::Vector());
+    gesture.speed = 0;
+    gesture.progress = 0;
+    gesture.radius = 0;
+
+    switch (leapGesture.type()) {
+        case Leap::Gesture::TYPE_SWIPE: {
+            const Leap::SwipeGesture swipe(leapGesture);
+            gesture.pointableId = swipe.pointable().id();
+            gesture.position = Float3::fromVector(swipe.position());
+            gesture.direction = Float3::fromVector(swipe.direction());
+            gesture.speed = swipe.speed();
+            break;
+        }
+        case Leap::Gesture::TYPE_CIRCLE: {
+            const Leap::CircleGesture circle(leapGesture);
+            gesture.pointableId = circle.pointable().id();
+            gesture.position = Float3::fromVector(circle.center());
+            gesture.direction = Float3::fromVector(circle.normal());
+            gesture.progress = circle.progress();
+            gesture.radius = circle.radius();
+            break;
+        }
+        case Leap::Gesture::TYPE_SCREEN_TAP: {
+            const Leap::ScreenTapGesture tap(leapGesture);
+            gesture.pointableId = tap.pointable().id();
+            gesture.position = Float3::fromVector(tap.position());
+            gesture.direction = Float3::fromVector(tap.direction());
+            gesture.progress = tap.progress();
+            break;
+        }
+        case Leap::Gesture::TYPE_KEY_TAP: {
+            const Leap::KeyTapGesture tap(leapGesture);
+            gesture.pointableId = tap.pointable().id();
+            gesture.position = Float3::fromVector(tap.position());
+            gesture.direction = Float3::fromVector(tap.direction());
+            gesture.progress = tap.progress();
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+static void captureHand(const Leap::Hand &leapHand, HandSnapshot &hand)
+{
+    hand.id = leapHand.id();
+    hand.palmPosition = Float3::fromVector(leapHand.palmPosition());
+    hand.palmVelocity = Float3::fromVector(leapHand.palmVelocity());
+    hand.palmNormal = Float3::fromVector(leapHand.palmNormal());
+    hand.direction = Float3::fromVector(leapHand.direction());
+    hand.sphereCenter = Float3::fromVector(leapHand.sphereCenter());
+    hand.sphereRadius = leapHand.sphereRadius();
+}
+
+static uint32_t capturePointables(const Leap::PointableList &list, PointableSnapshot *pointables, uint32_t capacity)
+{
+    const int count = list.count();
+    uint32_t copied = 0;
+    for (int i = 0; i < count && copied < capacity; i++) {
+        const Leap::Pointable leapPointable = list[i];
+        PointableSnapshot &pointable = pointables[copied++];
+        pointable.id = leapPointable.id();
+        const Leap::Hand hand = leapPointable.hand();
+        pointable.handId = hand.isValid() ? hand.id() : -1;
+        pointable.tipPosition = Float3::fromVector(leapPointable.tipPosition());
+        pointable.tipVelocity = Float3::fromVector(leapPointable.tipVelocity());
+        pointable.direction = Float3::fromVector(leapPointable.direction());
+        pointable.width = leapPointable.width();
+        pointable.length = leapPointable.length();
+        pointable.flags = (leapPointable.isFinger() ? PointableIsFinger : 0) | (leapPointable.isTool() ? PointableIsTool : 0);
+    }
+    return copied;
+}
+
+static void captureFrameWithGestures(const Leap::Frame &frame, const Leap::GestureList &gestures, FrameBuffer &buffer)
+{
+    buffer.id = frame.id();
+    buffer.timestamp = frame.timestamp();
+
+    const Leap::HandList hands = frame.hands();
+    const int handCount = hands.count();
+    buffer.handCount = 0;
+    for (int i = 0; i < handCount && buffer.handCount < MaxHands; i++) {
+        captureHand(hands[i], buffer.hands[buffer.handCount++]);
+    }
+
+    const Leap::PointableList pointables = frame.pointables();
+    const int pointableCount = pointables.count();
+    buffer.pointableCount = 0;
+    for (int i = 0; i < pointableCount && buffer.pointableCount < MaxPointables; i++) {
+        const Leap::Pointable pointable = pointables[i];
+        const uint32_t index = buffer.pointableCount++;
+        buffer.pointableIds[index] = pointable.id();
+        const Leap::Hand hand = pointable.hand();
+        buffer.pointableHandIds[index] = hand.isValid() ? hand.id() : -1;
+        buffer.pointableHandIndices[index] = NoHandIndex;
+        for (uint32_t h = 0; h < buffer.handCount; h++) {
+            if (buffer.hands[h].id == buffer.pointableHandIds[index]) {
+                buffer.pointableHandIndices[index] = (uint8_t)h;
+                break;
+            }
+        }
+        buffer.tipPositions.set(index, pointable.tipPosition());
+        buffer.tipVelocities.set(index, pointable.tipVelocity());
+        buffer.directions.set(index, pointable.direction());
+        buffer.widths[index] = pointable.width();
+        buffer.lengths[index] = pointable.length();
+        buffer.flags[index] = (pointable.isFinger() ? PointableIsFinger : 0) | (pointable.isTool() ? PointableIsTool : 0);
+    }
+
+    const int gestureCount = gestures.count();
+    buffer.gestureCount = 0;
+    for (int i = 0; i < gestureCount && buffer.gestureCount < MaxGestures; i++) {
+        captureGesture(gestures[i], buffer.gestures[buffer.gestureCount++]);
+    }
+}
+
+void captureFrame(const Leap::Frame &frame, FrameBuffer &buffer)
+{
+    captureFrameWithGestures(frame, frame.gestures(), buffer);
+}
+
+void captureFrame(const Leap::Frame &frame, const Leap::Frame &sinceFrame, FrameBuffer &buffer)
+{
+    captureFrameWithGestures(frame, frame.gestures(sinceFrame), buffer);
+}
+
+uint32_t copyHands(const Leap::Frame &frame, HandSnapshot *hands, uint32_t capacity)
+{
+    const Leap::HandList list = frame.hands();
+    const int count = list.count();
+    uint32_t copied = 0;
+    for (int i = 0; i < count && copied < capacity; i++) {
+        captureHand(list[i], hands[copied++]);
+    }
+    return copied;
+}
+
+uint32_t copyPointables(const Leap::Frame &frame, PointableSnapshot *pointables, uint32_t capacity)
+{
+    return capturePointables(frame.pointables(), pointables, capacity);
+}
+
+uint32_t copyPointables(const Leap::Hand &hand, PointableSnapshot *pointables, uint32_t capacity)
+{
+    return capturePointables(hand.pointables(), pointables, capacity);
+}
+
+int framesSince(const Leap::Controller &controller, const Leap::Frame &sinceFrame, Leap::Frame *frames, int capacity)
+{
+    if (capacity <= 0) {
+        return 0;
+    }
+    if (!sinceFrame.isValid()) {
+        frames[0] = controller.frame(0);
+        return 1;
+    }
+    for (int history = 0; history < capacity; history++) {
+        frames[history] = controller.frame(history);
+        if (!frames[history].isValid() || frames[history].id() <= sinceFrame.id()) {
+            return history;
+        }
+    }
+    return capacity;
+}
+
+}
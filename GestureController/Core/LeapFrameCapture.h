@@ -0,0 +1,50 @@
+//
+//  LeapFrameCapture.h
+//  OSXGestureControl
+//
+//  Copyright (c) 2013 Chris Willingham. All rights reserved.
+//
+//  Copies a Leap::Frame into a FrameBuffer. This is the only part of the
+//  core that links against the Leap library.
+//
+
+#ifndef OSXGestureControl_LeapFrameCapture_h
+#define OSXGestureControl_LeapFrameCapture_h
+
+#include "FrameSnapshot.h"
+
+namespace Leap {
+class Controller;
+class Frame;
+class Hand;
+}
+
+namespace GestureCore {
+
+// Anything past the FrameBuffer capacities is dropped.
+void captureFrame(const Leap::Frame &frame, FrameBuffer &buffer);
+
+// The same, but with every SDK gesture update since sinceFrame
+// (Frame::gestures(sinceFrame)) instead of only this frame's, so nothing is
+// lost across frames that were never captured.
+void captureFrame(const Leap::Frame &frame, const Leap::Frame &sinceFrame, FrameBuffer &buffer);
+
+// Copy-out of one list into a caller's contiguous records, for code that
+// wants the hands or pointables without a whole FrameBuffer. Each builds the
+// SDK list once and reads every element once. Returns how many records were
+// written, at most capacity; anything past it is dropped.
+uint32_t copyHands(const Leap::Frame &frame, HandSnapshot *hands, uint32_t capacity);
+uint32_t copyPointables(const Leap::Frame &frame, PointableSnapshot *pointables, uint32_t capacity);
+uint32_t copyPointables(const Leap::Hand &hand, PointableSnapshot *pointables, uint32_t capacity);
+
+// Frames the controller has produced since sinceFrame, the current one
+// included, stored newest first in frames so they needn't be fetched from
+// the controller twice. Returns how many: 1 when none were missed, 0 when
+// sinceFrame is still the current frame. Goes back through the
+// controller's history at most capacity frames, and stores just the
+// current one when sinceFrame is invalid.
+int framesSince(const Leap::Controller &controller, const Leap::Frame &sinceFrame, Leap::Frame *frames, int capacity);
+
+}
+
+#endif
@@ -0,0 +1,216 @@
+//
+//  PointableFilter.cpp
+//  OSXGestureControl
+//
+//  Copyright (c) 2013 Chris Willingham. All rights reserved.
+//
+
+#include "PointableFilter.h"
+
+#include <math.h>
+#include <string.h>
+
+namespace GestureCore {
+
+FilterParams::FilterParams()
+    : kind(FilterNone), minCutoff(5), beta(0.005f), derivativeCutoff(1),
+      accelerationNoise(4e6f), positionNoise(4), velocityNoise(40000)
+{
+}
+
+PointableFilter::PointableFilter() : _current(0)
+{
+    reset();
+}
+
+void PointableFilter::setParams(const FilterParams &params)
+{
+    const bool restart = params.kind != _params.kind;
+    _params = params;
+    if (restart) {
+        reset();
+    }
+}
+
+void PointableFilter::reset()
+{
+    _states[_current].count = 0;
+    _previousIds.clear();
+    _lastTimestamp = -1;
+}
+
+const FrameSnapshot &PointableFilter::filter(const FrameSnapshot &frame)
+{
+    if (frame.pointableCount > MaxPointables) {
+        reset();
+        return frame;
+    }
+    // no previous frame (or time going backwards) starts everything over
+    const float dt = _lastTimestamp >= 0 && frame.timestamp > _lastTimestamp ?
+        (frame.timestamp - _lastTimestamp) / 1e6f : 0;
+    _lastTimestamp = frame.timestamp;
+
+    // usually the same pointables in the same order as last frame, in which
+    // case the state is already lined up
+    const uint32_t count = frame.pointableCount;
+    if (dt <= 0 || _states[_current].count != count ||
+        memcmp(_states[_current].ids, frame.pointables.ids, count * sizeof(int32_t)) != 0) {
+        gather(frame, _states[1 - _current], dt);
+        _current = 1 - _current;
+    }
+    State &state = _states[_current];
+    if (dt > 0) {
+        if (_params.kind == FilterOneEuro) {
+            oneEuro(frame, state, dt);
+        } else {
+            kalman(frame, state, dt);
+        }
+    }
+
+    _filtered = frame;
+    _filtered.pointables.tipVelocities = state.velocity.arrays();
+    return _filtered;
+}
+
+void PointableFilter::gather(const FrameSnapshot &frame, State &next, float dt)
+{
+    const State &previous = _states[_current];
+    const PointableArrays &pointables = frame.pointables;
+    next.count = frame.pointableCount;
+    for (uint32_t i = 0; i < next.count; i++) {
+        const int32_t id = pointables.ids[i];
+        next.ids[i] = id;
+        const int p = dt > 0 ? _previousIds.find(id) : -1;
+        if (p >= 0) {
+            next.velocity.set(i, previous.velocity.arrays()[p]);
+            next.derivative.set(i, previous.derivative.arrays()[p]);
+            next.position.set(i, previous.position.arrays()[p]);
+            next.a[i] = previous.a[p];
+            next.b[i] = previous.b[p];
+            next.c[i] = previous.c[p];
+        } else {
+            // new pointables start at their raw values: no derivative, and a
+            // position the Kalman prediction carries onto the measured one
+            const Leap::Vector velocity = pointables.tipVelocities[i];
+            next.velocity.set(i, velocity);
+            next.derivative.set(i, Leap::Vector());
+            next.position.set(i, pointables.tipPositions[i] - velocity * dt);
+            next.a[i] = _params.positionNoise;
+            next.b[i] = 0;
+            next.c[i] = _params.velocityNoise;
+        }
+    }
+    _previousIds.clear();
+    for (uint32_t i = 0; i < next.count; i++) {
+        _previousIds.insert(next.ids[i], (uint8_t)i);
+    }
+}
+
+// Smoothing factor of a first order low pass at cutoff Hz.
+static inline float smoothing(float cutoff, float dt)
+{
+    // dt / (dt + tau) with tau = 1 / (2 pi cutoff), with one division
+    const float omega = 2 * Leap::PI * cutoff * dt;
+    return omega / (omega + 1);
+}
+
+void PointableFilter::oneEuro(const FrameSnapshot &frame, State &state, float dt)
+{
+    const uint32_t count = state.count;
+    const VectorArrays &raw = frame.pointables.tipVelocities;
+    const float *measured[3] = { raw.x, raw.y, raw.z };
+    float *values[3] = { state.velocity.x, state.velocity.y, state.velocity.z };
+    float *derivatives[3] = { state.derivative.x, state.derivative.y, state.derivative.z };
+
+    const float derivativeAlpha = smoothing(_params.derivativeCutoff, dt);
+    const float rate = 1 / dt;
+    for (int axis = 0; axis < 3; axis++) {
+        const float *z = measured[axis];
+        const float *v = values[axis];
+        float *d = derivatives[axis];
+        for (uint32_t i = 0; i < count; i++) {
+            d[i] += derivativeAlpha * ((z[i] - v[i]) * rate - d[i]);
+        }
+    }
+
+    float alpha[MaxPointables];
+    const float *dx = derivatives[0];
+    const float *dy = derivatives[1];
+    const float *dz = derivatives[2];
+    for (uint32_t i = 0; i < count; i++) {
+        const float cutoff = _params.minCutoff + _params.beta * sqrtf(dx[i] * dx[i] + dy[i] * dy[i] + dz[i] * dz[i]);
+        alpha[i] = smoothing(cutoff, dt);
+    }
+
+    for (int axis = 0; axis < 3; axis++) {
+        const float *z = measured[axis];
+        float *v = values[axis];
+        for (uint32_t i = 0; i < count; i++) {
+            v[i] += alpha[i] * (z[i] - v[i]);
+        }
+    }
+}
+
+void PointableFilter::kalman(const FrameSnapshot &frame, State &state, float dt)
+{
+    const uint32_t count = state.count;
+    const float q = _params.accelerationNoise;
+    const float rp = _params.positionNoise;
+    const float rv = _params.velocityNoise;
+
+    // Covariance and gains are shared by the three axes. The position and
+    // velocity measurements have independent noise, so they're folded in
+    // one after the other.
+    float positionGain[MaxPointables];
+    float positionVelocityGain[MaxPointables];
+    float velocityPositionGain[MaxPointables];
+    float velocityGain[MaxPointables];
+    float *a = state.a;
+    float *b = state.b;
+    float *c = state.c;
+    for (uint32_t i = 0; i < count; i++) {
+        // predict with F = [[1, dt], [0, 1]] and white noise acceleration
+        float pa = a[i] + dt * (2 * b[i] + dt * c[i]) + q * dt * dt * dt / 3;
+        float pb = b[i] + dt * c[i] + q * dt * dt / 2;
+        float pc = c[i] + q * dt;
+        // position measurement
+        float s = pa + rp;
+        positionGain[i] = pa / s;
+        positionVelocityGain[i] = pb / s;
+        pc -= positionVelocityGain[i] * pb;
+        pa *= 1 - positionGain[i];
+        pb *= 1 - positionGain[i];
+        // velocity measurement
+        s = pc + rv;
+        velocityPositionGain[i] = pb / s;
+        velocityGain[i] = pc / s;
+        a[i] = pa - velocityPositionGain[i] * pb;
+        b[i] = pb * (1 - velocityGain[i]);
+        c[i] = pc * (1 - velocityGain[i]);
+    }
+
+    const VectorArrays &rawPositions = frame.pointables.tipPositions;
+    const VectorArrays &rawVelocities = frame.pointables.tipVelocities;
+    const float *measuredPositions[3] = { rawPositions.x, rawPositions.y, rawPositions.z };
+    const float *measuredVelocities[3] = { rawVelocities.x, rawVelocities.y, rawVelocities.z };
+    float *positions[3] = { state.position.x, state.position.y, state.position.z };
+    float *velocities[3] = { state.velocity.x, state.velocity.y, state.velocity.z };
+    for (int axis = 0; axis < 3; axis++) {
+        const float *zp = measuredPositions[axis];
+        const float *zv = measuredVelocities[axis];
+        float *p = positions[axis];
+        float *v = velocities[axis];
+        for (uint32_t i = 0; i < count; i++) {
+            float position = p[i] + v[i] * dt;
+            float velocity = v[i];
+            const float positionError = zp[i] - position;
+            position += positionGain[i] * positionError;
+            velocity += positionVelocityGain[i] * positionError;
+            const float velocityError = zv[i] - velocity;
+            p[i] = position + velocityPositionGain[i] * velocityError;
+            v[i] = velocity + velocityGain[i] * velocityError;
+        }
+    }
+}
+
+}
@@ -0,0 +1,98 @@
+//
+//  PointableFilter.h
+//  OSXGestureControl
+//
+//  Copyright (c) 2013 Chris Willingham. All rights reserved.
+//
+//  Smooths fingertip velocities before the recognizers threshold them, so a
+//  single noisy frame can't fire or end a swipe on its own.
+//
+//  State is kept per pointable id in a fixed table, held in the order of the
+//  last frame's pointables and gathered into the new order only when the
+//  ids change. The filter itself is plain loops over per-component float
+//  arrays that the compiler can vectorize, and the result is handed on as
+//  the frame's tipVelocities arrays without copying the rest of the frame.
+//
+
+#ifndef OSXGestureControl_PointableFilter_h
+#define OSXGestureControl_PointableFilter_h
+
+#include "FrameHistory.h"
+#include "FrameSnapshot.h"
+
+namespace GestureCore {
+
+enum FilterKind {
+    FilterNone,
+    // One Euro filter: a low pass whose cutoff rises with the rate of change,
+    // so slow movement is smoothed hard and fast strokes lag little.
+    FilterOneEuro,
+    // Constant velocity Kalman filter over tip position and velocity.
+    FilterKalman
+};
+
+struct FilterParams {
+    FilterKind kind;
+    // One Euro
+    float minCutoff;        // Hz, cutoff when the velocity is steady
+    float beta;             // cutoff gained per mm/s^2 of acceleration
+    float derivativeCutoff; // Hz, for smoothing the acceleration itself
+    // Kalman
+    float accelerationNoise;    // process noise, (mm/s^2)^2 per Hz
+    float positionNoise;        // mm^2 measurement variance
+    float velocityNoise;        // (mm/s)^2 measurement variance
+
+    FilterParams();
+};
+
+class PointableFilter
+{
+public:
+    PointableFilter();
+
+    // Changing the kind starts every pointable over.
+    void setParams(const FilterParams &params);
+    const FilterParams &params() const { return _params; }
+
+    // frame with its tip velocities replaced by filtered ones; the rest
+    // still points at frame's storage and the velocities at the filter's,
+    // until the next call. Returns frame itself with FilterNone, or when it
+    // has more than MaxPointables pointables (which also resets the filter).
+    const FrameSnapshot &apply(const FrameSnapshot &frame)
+    {
+        return _params.kind == FilterNone ? frame : filter(frame);
+    }
+
+    void reset();
+
+private:
+    // Everything kept per pointable, in one frame's pointable order.
+    struct State {
+        uint32_t count;
+        int32_t ids[MaxPointables];
+        VectorStorage velocity;     // the filtered output
+        VectorStorage derivative;   // One Euro: smoothed acceleration
+        VectorStorage position;     // Kalman: filtered tip position
+        // Kalman covariance [[a, b], [b, c]] of (position, velocity), the
+        // same on every axis since they share noise and start alike
+        float a[MaxPointables];
+        float b[MaxPointables];
+        float c[MaxPointables];
+    };
+
+    const FrameSnapshot &filter(const FrameSnapshot &frame);
+    void gather(const FrameSnapshot &frame, State &next, float dt);
+    void oneEuro(const FrameSnapshot &frame, State &state, float dt);
+    void kalman(const FrameSnapshot &frame, State &state, float dt);
+
+    FilterParams _params;
+    State _states[2];
+    int _current;
+    IdIndex<6> _previousIds;
+    int64_t _lastTimestamp;
+    FrameSnapshot _filtered;
+};
+
+}
+
+#endif
@@ -0,0 +1,451 @@
+//
+//  Recognizers.cpp
+//  OSXGestureControl
+//
+//  Copyright (c) 2013 Chris Willingham. All rights reserved.
+//
+
+#include "Recognizers.h"
+
+#include <algorithm>
+
+namespace GestureCore {
+
+//////////////////////////////////////////////////////////////////////////
+//SHARED STATE
+DetectorParams::DetectorParams()
+    : verticalThreshold(700), horizontalThreshold(500), interactionPlaneZ(0), releaseRatio(0.6f)
+{
+    // roughly what the old 50 frame cooldown gave at the device's usual rate
+    for (int i = 0; i < 4; i++) {
+        refractoryMicros[i] = 400000;
+    }
+}
+
+SwipeGate::SwipeGate()
+{
+    for (int i = 0; i < 4; i++) {
+        _refractoryMicros[i] = DetectorParams().refractoryMicros[i];
+    }
+    reset();
+}
+
+void SwipeGate::setRefractory(const int64_t refractoryMicros[4])
+{
+    for (int i = 0; i < 4; i++) {
+        _refractoryMicros[i] = refractoryMicros[i];
+    }
+}
+
+bool SwipeGate::tryFire(Direction direction, int64_t timestamp)
+{
+    // timestamps going backwards (e.g. back to back recordings) restart the window
+    if (_hasFired[direction] && timestamp >= _lastFired[direction] &&
+        timestamp - _lastFired[direction] < _refractoryMicros[direction]) {
+        return false;
+    }
+    _hasFired[direction] = true;
+    _lastFired[direction] = timestamp;
+    return true;
+}
+
+void SwipeGate::reset()
+{
+    for (int i = 0; i < 4; i++) {
+        _hasFired[i] = false;
+        _lastFired[i] = 0;
+    }
+}
+
+bool RecentIds::contains(int32_t id) const
+{
+    for (int i = 0; i < Count; i++) {
+        if (_ids[i] == id) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void RecentIds::add(int32_t id)
+{
+    _ids[_next] = id;
+    _next = (_next + 1) % Count;
+}
+
+void RecentIds::clear()
+{
+    // SDK gesture ids start at 1
+    for (int i = 0; i < Count; i++) {
+        _ids[i] = -1;
+    }
+    _next = 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+//VELOCITY SWIPE
+VelocitySwipeRecognizer::VelocitySwipeRecognizer(SwipeGate &gate) : _gate(gate)
+{
+    reset();
+}
+
+void VelocitySwipeRecognizer::reset()
+{
+    _hands.clear();
+    _unattached = HandState();
+}
+
+void VelocitySwipeRecognizer::rearm(HandState &state, const Leap::Vector &avgVelocity) const
+{
+    const float vertical = _params.verticalThreshold * _params.releaseRatio;
+    const float horizontal = _params.horizontalThreshold * _params.releaseRatio;
+    state.armed[Up] = state.armed[Up] || avgVelocity.y < vertical;
+    state.armed[Down] = state.armed[Down] || avgVelocity.y > -vertical;
+    state.armed[Right] = state.armed[Right] || avgVelocity.x < horizontal;
+    state.armed[Left] = state.armed[Left] || avgVelocity.x > -horizontal;
+}
+
+bool VelocitySwipeRecognizer::processFrame(const FrameSnapshot &frame, GestureHandler &handler)
+{
+    // one group per hand, and the fingers without one in the last
+    enum { Groups = MaxHands + 1 };
+    FingerTotals totals[Groups];
+    const PointableArrays &pointables = frame.pointables;
+    const float *tipZ = pointables.tipPositions.z;
+    const VectorArrays &velocities = pointables.tipVelocities;
+    const uint32_t handCount = std::min<uint32_t>(frame.handCount, MaxHands);
+    // a hand's fingers are normally listed together, so add up each run of
+    // them locally and only then into the hand's totals
+    uint32_t runGroup = Groups;
+    FingerTotals run;
+    for (uint32_t i = 0; i < frame.pointableCount; i++) {
+        if (!(pointables.flags[i] & PointableIsFinger)) {
+            continue;
+        }
+        const uint32_t hand = pointables.handIndices[i];
+        const uint32_t group = hand < handCount ? hand : (uint32_t)MaxHands;
+        if (group != runGroup) {
+            if (runGroup != Groups) {
+                totals[runGroup] += run;
+            }
+            runGroup = group;
+            run = FingerTotals();
+        }
+        run.fingers++;
+        // only fingers pushed through the interaction plane take part
+        if (tipZ[i] < _params.interactionPlaneZ) {
+            run.inPlane++;
+            run.velocitySum += velocities[i];
+        }
+    }
+    if (runGroup != Groups) {
+        totals[runGroup] += run;
+    }
+
+    _hands.retain(frame);
+    for (uint32_t h = 0; h < handCount; h++) {
+        if (totals[h].fingers > 0) {
+            detect(frame, _hands.acquire(frame.hands[h].id), totals[h], handler);
+        }
+    }
+    if (totals[MaxHands].fingers > 0) {
+        detect(frame, _unattached, totals[MaxHands], handler);
+    }
+    return false;
+}
+
+void VelocitySwipeRecognizer::detect(const FrameSnapshot &frame, HandState &state, const FingerTotals &totals,
+                                     GestureHandler &handler)
+{
+    if (totals.inPlane == 0) {
+        // the hand pulled back out of the plane, which ends any stroke
+        state = HandState();
+        return;
+    }
+    const Leap::Vector avgVelocity = totals.velocitySum / (float)totals.fingers;
+    rearm(state, avgVelocity);
+
+    GestureEvent event(SWIPE_GESTURE, frame);
+    event.fingers = totals.fingers;
+    event.avgVelocity = avgVelocity;
+    if (avgVelocity.y > _params.verticalThreshold) {
+        event.direction = Up;
+    } else if (avgVelocity.y < -_params.verticalThreshold) {
+        event.direction = Down;
+    } else if (avgVelocity.x > _params.horizontalThreshold) {
+        event.direction = Right;
+    } else if (avgVelocity.x < -_params.horizontalThreshold) {
+        event.direction = Left;
+    } else {
+        return;
+    }
+    if (state.armed[event.direction] && _gate.tryFire(event.direction, frame.timestamp)) {
+        state.armed[event.direction] = false;
+        handler.onGesture(event);
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+//SDK GESTURES
+SdkSwipeRecognizer::SdkSwipeRecognizer(SwipeGate &gate) : _gate(gate)
+{
+}
+
+void SdkSwipeRecognizer::reset()
+{
+    _fired.clear();
+}
+
+bool SdkSwipeRecognizer::processFrame(const FrameSnapshot &frame, GestureHandler &handler)
+{
+    for (uint32_t i = 0; i < frame.gestureCount; i++) {
+        const GestureSnapshot &swipe = frame.gestures[i];
+        if (swipe.type != SdkGestureSwipe || _fired.contains(swipe.id)) {
+            continue;
+        }
+        GestureEvent event(SWIPE_GESTURE, frame);
+        if (swipe.direction.x > 0.75f) {
+            event.direction = Right;
+        } else if (swipe.direction.x < -0.75f) {
+            event.direction = Left;
+        } else if (swipe.direction.y < -0.75f) {
+            event.direction = Down;
+        } else if (swipe.direction.y > 0.75f) {
+            event.direction = Up;
+        } else {
+            continue;
+        }
+        // one event per SDK swipe, on the first frame it shows up in
+        _fired.add(swipe.id);
+        event.fingers = 1;
+        event.avgVelocity = swipe.direction.toVector() * swipe.speed;
+        event.position = swipe.position.toVector();
+        event.magnitude = swipe.speed;
+        if (_gate.tryFire(event.direction, frame.timestamp)) {
+            handler.onGesture(event);
+        }
+    }
+    return false;
+}
+
+CircleRecognizer::CircleRecognizer()
+{
+    reset();
+}
+
+void CircleRecognizer::reset()
+{
+    for (int i = 0; i < MaxCircles; i++) {
+        _ids[i] = -1;
+        _turns[i] = 0;
+    }
+    _next = 0;
+}
+
+bool CircleRecognizer::processFrame(const FrameSnapshot &frame, GestureHandler &handler)
+{
+    for (uint32_t i = 0; i < frame.gestureCount; i++) {
+        const GestureSnapshot &circle = frame.gestures[i];
+        if (circle.type != SdkGestureCircle) {
+            continue;
+        }
+        int slot = -1;
+        for (int c = 0; c < MaxCircles; c++) {
+            if (_ids[c] == circle.id) {
+                slot = c;
+                break;
+            }
+        }
+        if (slot < 0) {
+            slot = _next;
+            _next = (_next + 1) % MaxCircles;
+            _ids[slot] = circle.id;
+            _turns[slot] = 0;
+        }
+        const int turns = (int)circle.progress;
+        if (turns > _turns[slot]) {
+            _turns[slot] = turns;
+            GestureEvent event(CIRCLE_GESTURE, frame);
+            // the normal points along the finger when drawn clockwise
+            Leap::Vector pointing(0, 0, -1);
+            for (uint32_t p = 0; p < frame.pointableCount; p++) {
+                if (frame.pointables.ids[p] == circle.pointableId) {
+                    pointing = frame.pointables.directions[p];
+                    break;
+                }
+            }
+            event.direction = circle.direction.toVector().dot(pointing) > 0 ? Right : Left;
+            event.fingers = 1;
+            event.position = circle.position.toVector();
+            event.magnitude = circle.progress;
+            handler.onGesture(event);
+        }
+    }
+    return false;
+}
+
+void KeyTapRecognizer::reset()
+{
+    _fired.clear();
+}
+
+bool KeyTapRecognizer::processFrame(const FrameSnapshot &frame, GestureHandler &handler)
+{
+    for (uint32_t i = 0; i < frame.gestureCount; i++) {
+        const GestureSnapshot &tap = frame.gestures[i];
+        if (tap.type != SdkGestureKeyTap || _fired.contains(tap.id)) {
+            continue;
+        }
+        _fired.add(tap.id);
+        GestureEvent event(KEY_TAP_GESTURE, frame);
+        event.direction = Down;
+        event.fingers = 1;
+        event.position = tap.position.toVector();
+        handler.onGesture(event);
+    }
+    return false;
+}
+
+//////////////////////////////////////////////////////////////////////////
+//HAND SHAPES
+PinchRecognizer::PinchRecognizer() : pinchDistance(DefaultPinchDistance), releaseDistance(DefaultPinchReleaseDistance)
+{
+}
+
+void PinchRecognizer::reset()
+{
+    _hands.clear();
+}
+
+bool PinchRecognizer::processFrame(const FrameSnapshot &frame, GestureHandler &handler)
+{
+    _hands.retain(frame);
+    const PointableArrays &pointables = frame.pointables;
+    bool engaged = false;
+    for (uint32_t h = 0; h < frame.handCount; h++) {
+        // closest pair of this hand's fingertips
+        float closest = -1;
+        int fingers = 0;
+        Leap::Vector midpoint;
+        for (uint32_t i = 0; i < frame.pointableCount; i++) {
+            if (pointables.handIndices[i] != h || !(pointables.flags[i] & PointableIsFinger)) {
+                continue;
+            }
+            fingers++;
+            const Leap::Vector a = pointables.tipPositions[i];
+            for (uint32_t j = i + 1; j < frame.pointableCount; j++) {
+                if (pointables.handIndices[j] != h || !(pointables.flags[j] & PointableIsFinger)) {
+                    continue;
+                }
+                const Leap::Vector b = pointables.tipPositions[j];
+                const float distance = a.distanceTo(b);
+                if (closest < 0 || distance < closest) {
+                    closest = distance;
+                    midpoint = (a + b) / 2;
+                }
+            }
+        }
+        HandState &state = _hands.acquire(frame.hands[h].id);
+        // with fewer than two fingers the tips may just have merged, so keep the state
+        if (closest >= 0) {
+            if (!state.pinched && closest < pinchDistance) {
+                state.pinched = true;
+                GestureEvent event(PINCH_GESTURE, frame);
+                event.fingers = fingers;
+                event.position = midpoint;
+                event.magnitude = closest;
+                handler.onGesture(event);
+            } else if (state.pinched && closest > releaseDistance) {
+                state.pinched = false;
+            }
+        }
+        engaged = engaged || state.pinched;
+    }
+    return engaged;
+}
+
+HoldRecognizer::HoldRecognizer() : maxSpeed(DefaultHoldMaxSpeed), holdMicros(DefaultHoldMicros)
+{
+}
+
+void HoldRecognizer::reset()
+{
+    _hands.clear();
+}
+
+bool HoldRecognizer::processFrame(const FrameSnapshot &frame, GestureHandler &handler)
+{
+    _hands.retain(frame);
+    for (uint32_t h = 0; h < frame.handCount; h++) {
+        const HandSnapshot &hand = frame.hands[h];
+        const float speed = hand.palmVelocity.toVector().magnitude();
+        HandState &state = _hands.acquire(hand.id);
+        if (speed > maxSpeed * 2) {
+            state.still = false;
+            state.fired = false;
+        } else if (speed < maxSpeed && !state.still) {
+            state.still = true;
+            state.stillSince = frame.timestamp;
+        }
+        if (state.still && !state.fired && frame.timestamp - state.stillSince >= holdMicros) {
+            state.fired = true;
+            GestureEvent event(HOLD_GESTURE, frame);
+            event.position = hand.palmPosition.toVector();
+            event.magnitude = (frame.timestamp - state.stillSince) / 1e6f;
+            handler.onGesture(event);
+        }
+    }
+    return _hands.any();
+}
+
+//////////////////////////////////////////////////////////////////////////
+//TWO HANDS
+TwoHandZoomRecognizer::TwoHandZoomRecognizer() : zoomRatio(DefaultZoomRatio), minDistance(DefaultZoomMinDistance)
+{
+    reset();
+}
+
+void TwoHandZoomRecognizer::reset()
+{
+    _tracking = false;
+    _ids[0] = _ids[1] = -1;
+    _baseline = 0;
+}
+
+bool TwoHandZoomRecognizer::processFrame(const FrameSnapshot &frame, GestureHandler &handler)
+{
+    if (frame.handCount != 2) {
+        _tracking = false;
+        return false;
+    }
+    const HandSnapshot &first = frame.hands[0];
+    const HandSnapshot &second = frame.hands[1];
+    const Leap::Vector firstPalm = first.palmPosition.toVector();
+    const Leap::Vector secondPalm = second.palmPosition.toVector();
+    const float distance = firstPalm.distanceTo(secondPalm);
+    const bool sameHands = _tracking &&
+        ((first.id == _ids[0] && second.id == _ids[1]) || (first.id == _ids[1] && second.id == _ids[0]));
+    if (!sameHands || _baseline < minDistance) {
+        // a new pair, or palms too close to measure a scale from
+        _tracking = true;
+        _ids[0] = first.id;
+        _ids[1] = second.id;
+        _baseline = distance;
+        return true;
+    }
+
+    const float scale = distance / _baseline;
+    if (scale < zoomRatio && scale * zoomRatio > 1) {
+        return true;
+    }
+    GestureEvent event(ZOOM_GESTURE, frame);
+    event.direction = scale > 1 ? Up : Down;
+    event.avgVelocity = (first.palmVelocity.toVector() + second.palmVelocity.toVector()) / 2;
+    event.position = (firstPalm + secondPalm) / 2;
+    event.magnitude = scale;
+    handler.onGesture(event);
+    _baseline = distance;
+    return true;
+}
+
+}
@@ -0,0 +1,307 @@
+//
+//  Recognizers.h
+//  OSXGestureControl
+//
+//  Copyright (c) 2013 Chris Willingham. All rights reserved.
+//
+//  The built-in recognizers. GestureDetector owns one of each; only the
+//  velocity swipe is enabled by default. The SDK based ones (SDK swipe,
+//  circle, key tap) only see anything once the gesture is enabled on the
+//  Leap controller.
+//
+
+#ifndef OSXGestureControl_Recognizers_h
+#define OSXGestureControl_Recognizers_h
+
+#include "GestureRecognizer.h"
+
+namespace GestureCore {
+
+// Tunables for the velocity swipe detector. Times are in microseconds of
+// Leap::Frame::timestamp(), so behaviour doesn't depend on frame rate.
+struct DetectorParams {
+    float verticalThreshold;        // mm/s of average finger velocity on y
+    float horizontalThreshold;      // mm/s on x
+    float interactionPlaneZ;        // fingers only count once tip z is below this
+    // Hysteresis: after firing, a direction re-arms only once its velocity
+    // has dropped below releaseRatio * threshold (or the fingers left the
+    // interaction plane), so one long stroke can't fire twice.
+    float releaseRatio;
+    // Minimum time between two gestures in the same direction, per Direction.
+    int64_t refractoryMicros[4];
+
+    DetectorParams();
+};
+
+// Per-direction refractory windows shared by every swipe recognizer, so one
+// physical swipe seen by two of them only fires once.
+class SwipeGate
+{
+public:
+    SwipeGate();
+
+    void setRefractory(const int64_t refractoryMicros[4]);
+
+    // Returns true, and starts the direction's window, unless the direction
+    // is still inside its window.
+    bool tryFire(Direction direction, int64_t timestamp);
+
+    void reset();
+
+private:
+    int64_t _refractoryMicros[4];
+    bool _hasFired[4];
+    int64_t _lastFired[4];
+};
+
+// Per-hand state keyed by hand id, for recognizers that track each hand.
+template<typename State>
+class HandStates
+{
+public:
+    HandStates() { clear(); }
+
+    // The state for handId, created (value initialized) if it's new.
+    State &acquire(int32_t handId)
+    {
+        for (int i = 0; i < MaxHands; i++) {
+            if (_used[i] && _ids[i] == handId) {
+                return _states[i];
+            }
+        }
+        for (int i = 0; i < MaxHands; i++) {
+            if (!_used[i]) {
+                _used[i] = true;
+                _ids[i] = handId;
+                _states[i] = State();
+                return _states[i];
+            }
+        }
+        // more hands than MaxHands; recycle the first slot
+        _ids[0] = handId;
+        _states[0] = State();
+        return _states[0];
+    }
+
+    // Forgets hands that aren't in frame.
+    void retain(const FrameSnapshot &frame)
+    {
+        for (int i = 0; i < MaxHands; i++) {
+            bool present = false;
+            for (uint32_t h = 0; h < frame.handCount && !present; h++) {
+                present = frame.hands[h].id == _ids[i];
+            }
+            _used[i] = _used[i] && present;
+        }
+    }
+
+    bool any() const
+    {
+        for (int i = 0; i < MaxHands; i++) {
+            if (_used[i]) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void clear()
+    {
+        for (int i = 0; i < MaxHands; i++) {
+            _used[i] = false;
+            _ids[i] = 0;
+        }
+    }
+
+private:
+    bool _used[MaxHands];
+    int32_t _ids[MaxHands];
+    State _states[MaxHands];
+};
+
+// The few most recent SDK gesture ids a recognizer has acted on.
+class RecentIds
+{
+public:
+    RecentIds() { clear(); }
+    bool contains(int32_t id) const;
+    void add(int32_t id);
+    void clear();
+
+private:
+    enum { Count = 8 };
+    int32_t _ids[Count];
+    int _next;
+};
+
+// Swipes from the average velocity of the fingers through the interaction
+// plane: the original detector. Each hand is judged on its own fingers, so
+// two hands moving opposite ways don't cancel out and a second hand coming
+// into view doesn't change the first one's finger count. Fingers the
+// device couldn't attach to a hand are treated as one more hand.
+class VelocitySwipeRecognizer : public GestureRecognizer
+{
+public:
+    explicit VelocitySwipeRecognizer(SwipeGate &gate);
+
+    void setParams(const DetectorParams &params) { _params = params; }
+    const DetectorParams &params() const { return _params; }
+
+    virtual unsigned inputs() const { return FrameHasFingers; }
+    virtual bool processFrame(const FrameSnapshot &frame, GestureHandler &handler);
+    virtual void reset();
+
+private:
+    struct HandState {
+        bool armed[4];
+        HandState() { armed[Up] = armed[Down] = armed[Left] = armed[Right] = true; }
+    };
+
+    struct FingerTotals {
+        int fingers;
+        int inPlane;
+        Leap::Vector velocitySum;   // of the fingers in the plane
+        FingerTotals() : fingers(0), inPlane(0) {}
+        FingerTotals &operator+=(const FingerTotals &other)
+        {
+            fingers += other.fingers;
+            inPlane += other.inPlane;
+            velocitySum += other.velocitySum;
+            return *this;
+        }
+    };
+
+    void rearm(HandState &state, const Leap::Vector &avgVelocity) const;
+    void detect(const FrameSnapshot &frame, HandState &state, const FingerTotals &totals, GestureHandler &handler);
+
+    SwipeGate &_gate;
+    DetectorParams _params;
+    HandStates<HandState> _hands;
+    HandState _unattached;
+};
+
+// Leap SDK swipe gestures, mapped onto the four directions when the swipe
+// direction is within ~40 degrees of an axis.
+class SdkSwipeRecognizer : public GestureRecognizer
+{
+public:
+    explicit SdkSwipeRecognizer(SwipeGate &gate);
+
+    virtual unsigned inputs() const { return FrameHasSdkGestures; }
+    virtual bool processFrame(const FrameSnapshot &frame, GestureHandler &handler);
+    virtual void reset();
+
+private:
+    SwipeGate &_gate;
+    RecentIds _fired;
+};
+
+// Leap SDK circle gestures, reported once per completed turn.
+class CircleRecognizer : public GestureRecognizer
+{
+public:
+    CircleRecognizer();
+
+    virtual unsigned inputs() const { return FrameHasSdkGestures; }
+    virtual bool processFrame(const FrameSnapshot &frame, GestureHandler &handler);
+    virtual void reset();
+
+private:
+    enum { MaxCircles = 4 };
+    int32_t _ids[MaxCircles];
+    int _turns[MaxCircles];
+    int _next;
+};
+
+// Leap SDK key taps.
+class KeyTapRecognizer : public GestureRecognizer
+{
+public:
+    virtual unsigned inputs() const { return FrameHasSdkGestures; }
+    virtual bool processFrame(const FrameSnapshot &frame, GestureHandler &handler);
+    virtual void reset();
+
+private:
+    RecentIds _fired;
+};
+
+// Defaults of the recognizers below, shared with GestureConfig.
+static const float DefaultPinchDistance = 25;           // mm
+static const float DefaultPinchReleaseDistance = 45;    // mm
+static const float DefaultZoomRatio = 1.4f;
+static const float DefaultZoomMinDistance = 40;         // mm
+static const float DefaultHoldMaxSpeed = 40;            // mm/s
+static const int64_t DefaultHoldMicros = 800000;
+
+// Two fingertips of one hand closing to within pinchDistance. Fires once,
+// then waits for them to open past releaseDistance.
+class PinchRecognizer : public GestureRecognizer
+{
+public:
+    PinchRecognizer();
+
+    float pinchDistance;    // mm
+    float releaseDistance;  // mm
+
+    virtual unsigned inputs() const { return FrameHasFingers; }
+    virtual bool processFrame(const FrameSnapshot &frame, GestureHandler &handler);
+    virtual void reset();
+
+private:
+    struct HandState {
+        bool pinched;
+        HandState() : pinched(false) {}
+    };
+    HandStates<HandState> _hands;
+};
+
+// Two hands spreading apart or closing together, for zoom. Tracks the
+// distance between the palms, as Hand::scaleFactor does across frames, and
+// fires once it has grown (Up) or shrunk (Down) by zoomRatio since the
+// hands came into view or the last step, then measures the next step from
+// there. avgVelocity is the pair's mean palm velocity, for panning along.
+class TwoHandZoomRecognizer : public GestureRecognizer
+{
+public:
+    TwoHandZoomRecognizer();
+
+    float zoomRatio;    // scale for one step, above 1
+    float minDistance;  // mm; palms closer than this don't set a baseline
+
+    virtual unsigned inputs() const { return FrameHasHands; }
+    virtual bool processFrame(const FrameSnapshot &frame, GestureHandler &handler);
+    virtual void reset();
+
+private:
+    bool _tracking;
+    int32_t _ids[2];
+    float _baseline;
+};
+
+// A palm kept below maxSpeed for holdMicros. Fires once, then waits for the
+// palm to move faster than twice maxSpeed.
+class HoldRecognizer : public GestureRecognizer
+{
+public:
+    HoldRecognizer();
+
+    float maxSpeed;     // mm/s
+    int64_t holdMicros;
+
+    virtual unsigned inputs() const { return FrameHasHands; }
+    virtual bool processFrame(const FrameSnapshot &frame, GestureHandler &handler);
+    virtual void reset();
+
+private:
+    struct HandState {
+        bool still;
+        bool fired;
+        int64_t stillSince;
+        HandState() : still(false), fired(false), stillSince(0) {}
+    };
+    HandStates<HandState> _hands;
+};
+
+}
+
+#endif
@@ -0,0 +1,333 @@
+//
+//  ScrollEngine.cpp
+//  OSXGestureControl
+//
+//  Copyright (c) 2013 Chris Willingham. All rights reserved.
+//
+
+#include "ScrollEngine.h"
+
+#include <math.h>
+#include <algorithm>
+#include <chrono>
+
+namespace GestureCore {
+
+// Time constant of the velocity kept for momentum, so the release carries
+// the last few frames' speed rather than whatever the final frame caught
+// as the fingers lifted.
+static const float MomentumSmoothingSeconds = 0.05f;
+
+// What setParams() clamps to.
+static const float MinOutputHz = 1;
+static const float MaxOutputHz = 1000;
+static const float MaxGain = 100;
+static const float MinStopSpeed = 0.1f;
+
+// How long an idle output thread sleeps before looking for input anyway.
+static const int64_t IdleWakeMicros = 50000;
+
+ScrollParams::ScrollParams() : outputHz(60), gain(1.5f), friction(4), stopSpeed(20), maxGapMicros(100000)
+{
+}
+
+//////////////////////////////////////////////////////////////////////////
+//ENGINE
+ScrollEngine::ScrollEngine()
+    : _lastTrack(0), _tracking(false), _momentum(false), _lastTick(-1), _appliedX(0), _appliedY(0),
+      _releases(0), _cancels(0), _pendingX(0), _pendingY(0), _velocityX(0), _velocityY(0), _posted(0), _running(false)
+{
+}
+
+ScrollEngine::~ScrollEngine()
+{
+    stop();
+}
+
+void ScrollEngine::publish()
+{
+    _inputs.push(_input);
+}
+
+void ScrollEngine::setParams(const ScrollParams &params)
+{
+    ScrollParams &clamped = _input.params;
+    clamped = params;
+    // these come straight from a hot-reloaded config, so keep them usable:
+    // negative friction would speed momentum up rather than slow it (0
+    // turns momentum off), stopSpeed 0 would never let it stop, and a NaN
+    // anywhere would end up in the pending offset
+    if (!(clamped.outputHz >= MinOutputHz)) {
+        clamped.outputHz = MinOutputHz;
+    }
+    clamped.outputHz = std::min(clamped.outputHz, MaxOutputHz);
+    if (clamped.gain != clamped.gain) {
+        clamped.gain = 0;
+    }
+    clamped.gain = std::min(std::max(clamped.gain, -MaxGain), MaxGain);
+    if (!(clamped.friction >= 0)) {
+        clamped.friction = 0;
+    }
+    if (!(clamped.stopSpeed >= MinStopSpeed)) {
+        clamped.stopSpeed = MinStopSpeed;
+    }
+    if (clamped.maxGapMicros < 0) {
+        clamped.maxGapMicros = 0;
+    }
+    publish();
+}
+
+void ScrollEngine::track(float velocityX, float velocityY, int64_t timestampMicros)
+{
+    const bool touchDown = !_input.tracking;
+    const float pixelsX = velocityX * _input.params.gain;
+    const float pixelsY = velocityY * _input.params.gain;
+    const int64_t gap = timestampMicros - _lastTrack;
+    if (!touchDown && gap > 0 && gap <= _input.params.maxGapMicros) {
+        const float dt = gap / 1e6f;
+        _input.totalX += pixelsX * dt;
+        _input.totalY += pixelsY * dt;
+        const float alpha = dt / (dt + MomentumSmoothingSeconds);
+        _input.velocityX += alpha * (pixelsX - _input.velocityX);
+        _input.velocityY += alpha * (pixelsY - _input.velocityY);
+    } else {
+        _input.velocityX = pixelsX;
+        _input.velocityY = pixelsY;
+    }
+    _input.tracking = true;
+    _lastTrack = timestampMicros;
+    publish();
+    // the output side may be asleep; once it's ticking it'll see the rest
+    if (touchDown) {
+        _signal.notify();
+    }
+}
+
+void ScrollEngine::release()
+{
+    if (!_input.tracking) {
+        return;
+    }
+    _input.tracking = false;
+    _input.releases++;
+    publish();
+}
+
+void ScrollEngine::cancel()
+{
+    _input.tracking = false;
+    _input.velocityX = 0;
+    _input.velocityY = 0;
+    _input.cancelledX = _input.totalX;
+    _input.cancelledY = _input.totalY;
+    _input.cancels++;
+    publish();
+}
+
+void ScrollEngine::applyInput()
+{
+    Input input;
+    bool received = false;
+    while (_inputs.pop(input)) {
+        received = true;
+    }
+    if (!received) {
+        return;
+    }
+    _params = input.params;
+    if (input.cancels != _cancels) {
+        _cancels = input.cancels;
+        _momentum = false;
+        _pendingX = 0;
+        _pendingY = 0;
+        _velocityX = 0;
+        _velocityY = 0;
+        _appliedX = input.cancelledX;
+        _appliedY = input.cancelledY;
+    }
+    _pendingX += (float)(input.totalX - _appliedX);
+    _pendingY += (float)(input.totalY - _appliedY);
+    _appliedX = input.totalX;
+    _appliedY = input.totalY;
+    if (input.tracking) {
+        // touching down again also catches any momentum still going
+        _momentum = false;
+    } else if (input.releases != _releases) {
+        _velocityX = input.velocityX;
+        _velocityY = input.velocityY;
+        _momentum = hypotf(_velocityX, _velocityY) >= _params.stopSpeed && _params.friction > 0;
+        if (!_momentum) {
+            _velocityX = 0;
+            _velocityY = 0;
+        }
+    }
+    _releases = input.releases;
+    _tracking = input.tracking;
+}
+
+bool ScrollEngine::isActive()
+{
+    applyInput();
+    return _tracking || _momentum || fabsf(_pendingX) >= 1 || fabsf(_pendingY) >= 1;
+}
+
+bool ScrollEngine::tick(int64_t nowMicros, ActionSink &sink)
+{
+    applyInput();
+    // a stalled clock mustn't turn into one huge momentum step
+    const int64_t elapsed = _lastTick < 0 ? 0 : std::min(std::max(nowMicros - _lastTick, (int64_t)0), _params.maxGapMicros);
+    _lastTick = nowMicros;
+    // friction set to 0 since the release
+    if (_momentum && _params.friction <= 0) {
+        _momentum = false;
+        _velocityX = 0;
+        _velocityY = 0;
+    }
+    if (_momentum && elapsed > 0) {
+        const float dt = elapsed / 1e6f;
+        const float decay = expf(-_params.friction * dt);
+        // distance covered by a velocity decaying over dt
+        const float travel = (1 - decay) / _params.friction;
+        _pendingX += _velocityX * travel;
+        _pendingY += _velocityY * travel;
+        _velocityX *= decay;
+        _velocityY *= decay;
+        if (hypotf(_velocityX, _velocityY) < _params.stopSpeed) {
+            _momentum = false;
+            _velocityX = 0;
+            _velocityY = 0;
+        }
+    }
+    // whole pixels go out, the fraction carries to the next tick
+    Action action = { ActionScroll, 0, false, (int32_t)_pendingX, (int32_t)_pendingY };
+    if (action.dx == 0 && action.dy == 0) {
+        return false;
+    }
+    _pendingX -= action.dx;
+    _pendingY -= action.dy;
+    _posted.fetch_add(1, std::memory_order_relaxed);
+    sink.perform(action);
+    return true;
+}
+
+void ScrollEngine::start(ActionSink &sink)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_running.load(std::memory_order_relaxed)) {
+        return;
+    }
+    _running.store(true, std::memory_order_release);
+    _worker = std::thread(&ScrollEngine::run, this, std::ref(sink));
+}
+
+void ScrollEngine::stop()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (!_running.load(std::memory_order_relaxed)) {
+        return;
+    }
+    _running.store(false, std::memory_order_release);
+    _signal.notify();
+    _worker.join();
+}
+
+void ScrollEngine::run(ActionSink &sink)
+{
+    typedef std::chrono::steady_clock Clock;
+    Clock::time_point next = Clock::now();
+    while (_running.load(std::memory_order_acquire)) {
+        if (!isActive()) {
+            // nothing to post: sleep until track() has something, and
+            // restart the output clock from there. The input side never
+            // locks, so a wakeup lost to that race costs IdleWakeMicros.
+            _lastTick = -1;
+            _signal.wait(std::chrono::microseconds(IdleWakeMicros));
+            next = Clock::now();
+            continue;
+        }
+        const Clock::time_point now = Clock::now();
+        tick(std::chrono::duration_cast<std::chrono::microseconds>(now.time_since_epoch()).count(), sink);
+        // ticks missed while the sink was slow are skipped, not made up
+        const std::chrono::microseconds period((int64_t)(1e6f / _params.outputHz));
+        next += period;
+        if (next <= now) {
+            next = now + period;
+        }
+        const Clock::time_point after = Clock::now();
+        if (next > after) {
+            _signal.wait(std::chrono::duration_cast<std::chrono::microseconds>(next - after));
+        }
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+//RECOGNIZER
+ScrollRecognizer::ScrollRecognizer() : fingers(DefaultScrollFingers), interactionPlaneZ(0), deadZone(DefaultScrollDeadZone), _engine(NULL), _tracking(false)
+{
+}
+
+void ScrollRecognizer::setEngine(ScrollEngine *engine)
+{
+    reset();
+    _engine = engine;
+    if (_engine != NULL) {
+        _engine->setParams(_params);
+    }
+}
+
+void ScrollRecognizer::setParams(const ScrollParams &params)
+{
+    _params = params;
+    if (_engine != NULL) {
+        _engine->setParams(_params);
+    }
+}
+
+static inline float outsideDeadZone(float velocity, float deadZone)
+{
+    return fabsf(velocity) < deadZone ? 0 : velocity;
+}
+
+bool ScrollRecognizer::processFrame(const FrameSnapshot &frame, GestureHandler &)
+{
+    if (_engine == NULL) {
+        return false;
+    }
+    // in-plane fingers per hand, with unattached fingers as one more group
+    int counts[MaxHands + 1] = { 0 };
+    float sumX[MaxHands + 1] = { 0 };
+    float sumY[MaxHands + 1] = { 0 };
+    const PointableArrays &pointables = frame.pointables;
+    for (uint32_t i = 0; i < frame.pointableCount; i++) {
+        if (!(pointables.flags[i] & PointableIsFinger) || pointables.tipPositions.z[i] >= interactionPlaneZ) {
+            continue;
+        }
+        const int group = std::min((int)pointables.handIndices[i], (int)MaxHands);
+        counts[group]++;
+        sumX[group] += pointables.tipVelocities.x[i];
+        sumY[group] += pointables.tipVelocities.y[i];
+    }
+    for (int group = 0; group <= MaxHands; group++) {
+        if (counts[group] == fingers && fingers > 0) {
+            _engine->track(outsideDeadZone(sumX[group] / fingers, deadZone),
+                           outsideDeadZone(sumY[group] / fingers, deadZone), frame.timestamp);
+            _tracking = true;
+            return true;
+        }
+    }
+    if (_tracking) {
+        _engine->release();
+        _tracking = false;
+    }
+    return false;
+}
+
+void ScrollRecognizer::reset()
+{
+    if (_tracking && _engine != NULL) {
+        _engine->cancel();
+    }
+    _tracking = false;
+}
+
+}
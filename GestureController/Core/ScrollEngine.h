@@ -0,0 +1,177 @@
+//
+//  ScrollEngine.h
+//  OSXGestureControl
+//
+//  Copyright (c) 2013 Chris Willingham. All rights reserved.
+//
+//  Continuous scrolling. Posting a scroll event per sensor frame floods the
+//  event stream, so the engine decouples the two sides: tracked fingertip
+//  motion is integrated into a sub-pixel scroll offset as frames arrive,
+//  and the offset is drained at a fixed output rate (display refresh, say)
+//  as one coalesced ActionScroll per tick. Whatever the sensor rate, that's
+//  at most outputHz events a second, and fractions of a pixel carry over
+//  rather than being lost. When the fingers lift, the last velocity keeps
+//  scrolling and decays exponentially (momentum).
+//
+//  ScrollRecognizer is what feeds the engine from GestureDetector frames.
+//
+
+#ifndef OSXGestureControl_ScrollEngine_h
+#define OSXGestureControl_ScrollEngine_h
+
+#include <stdint.h>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include "ActionDispatcher.h"
+#include "FrameRing.h"
+#include "GestureRecognizer.h"
+
+namespace GestureCore {
+
+struct ScrollParams {
+    float outputHz;         // ticks per second, so events per second at most
+    float gain;             // pixels per mm of fingertip travel; negative inverts
+    float friction;         // per second: momentum decays as exp(-friction * t)
+    float stopSpeed;        // px/s; slower momentum stops, and a release slower than this has none
+    int64_t maxGapMicros;   // frames further apart than this don't scroll across the gap
+
+    ScrollParams();
+};
+
+// The input side (setParams, track, release, cancel) belongs to one thread
+// at a time, normally the detector thread; the output side (tick, isActive)
+// to another. Neither ever waits on the other: after each input call the
+// input side's whole state (running totals, not deltas) goes through an
+// SpscRing, and the output side only needs the latest entry. The mutex
+// only guards start() and stop().
+class ScrollEngine
+{
+public:
+    ScrollEngine();
+    ~ScrollEngine();
+
+    // Input side. Out of range values are clamped: outputHz to 1-1000, gain
+    // to +-100, friction to at least 0 (no momentum) and stopSpeed to at
+    // least 0.1.
+    void setParams(const ScrollParams &params);
+    const ScrollParams &params() const { return _input.params; }
+
+    // Input side. velocity is the fingertips' in mm/s at the frame's
+    // timestamp (sensor clock, microseconds).
+    void track(float velocityX, float velocityY, int64_t timestampMicros);
+    // The fingers lifted: momentum takes over from the last velocity.
+    void release();
+    // Stops at once: no momentum, and nothing pending is posted.
+    void cancel();
+
+    // Output side. Moves the output clock to nowMicros (its own clock, need
+    // not match the sensor's), advances momentum and posts whole pixels of
+    // the pending offset to sink as one ActionScroll. Returns whether it
+    // posted. Momentum doesn't advance on the first tick, which only starts
+    // the clock.
+    bool tick(int64_t nowMicros, ActionSink &sink);
+
+    // Output side. Whether there's anything for tick() to do: tracking,
+    // momentum or pending pixels.
+    bool isActive();
+
+    // Runs tick() at outputHz on a thread of its own, sleeping while idle.
+    // While it runs, that thread is the output side.
+    void start(ActionSink &sink);
+    void stop();
+
+    uint64_t eventsPosted() const { return _posted.load(std::memory_order_relaxed); }
+
+private:
+    ScrollEngine(const ScrollEngine &);
+    ScrollEngine &operator=(const ScrollEngine &);
+
+    // Everything the output side needs from the input side.
+    struct Input {
+        ScrollParams params;
+        double totalX;          // px tracked since construction
+        double totalY;
+        double cancelledX;      // totals at the last cancel()
+        double cancelledY;
+        float velocityX;        // px/s, smoothed while tracking, 0 once cancelled
+        float velocityY;
+        uint32_t releases;
+        uint32_t cancels;
+        bool tracking;
+        Input() : totalX(0), totalY(0), cancelledX(0), cancelledY(0), velocityX(0), velocityY(0),
+                  releases(0), cancels(0), tracking(false) {}
+    };
+
+    void publish();
+    // output side: catches up with the latest Input
+    void applyInput();
+    void run(ActionSink &sink);
+
+    // input side
+    Input _input;
+    int64_t _lastTrack;     // sensor clock
+
+    // only the newest entry matters, so a full ring losing the oldest is fine
+    SpscRing<Input, 4> _inputs;
+    FrameSignal _signal;
+
+    // output side
+    ScrollParams _params;
+    bool _tracking;
+    bool _momentum;
+    int64_t _lastTick;      // output clock, -1 before the first tick
+    double _appliedX;       // input totals already added to pending
+    double _appliedY;
+    uint32_t _releases;
+    uint32_t _cancels;
+    float _pendingX;        // px not posted yet, including any fraction
+    float _pendingY;
+    float _velocityX;       // px/s, momentum
+    float _velocityY;
+    std::atomic<uint64_t> _posted;
+
+    std::mutex _mutex;
+    std::thread _worker;
+    std::atomic<bool> _running;
+};
+
+// Defaults of ScrollRecognizer's fields, shared with GestureConfig.
+static const int DefaultScrollFingers = 2;
+static const float DefaultScrollDeadZone = 30;  // mm/s
+
+// Fingers of one hand held in the interaction plane drive a ScrollEngine
+// with their mean tip velocity; lifting them (or a different finger count)
+// releases it into momentum. Reports no GestureEvents: scrolling is
+// continuous and goes out at the engine's rate. Does nothing without an
+// engine. The velocity swipe sees the same fingers, so it's usually best
+// not to map swipes with this many fingers while scrolling is on.
+class ScrollRecognizer : public GestureRecognizer
+{
+public:
+    ScrollRecognizer();
+
+    void setEngine(ScrollEngine *engine);
+    ScrollEngine *engine() const { return _engine; }
+
+    // Handed on to the engine, now and whenever one is set.
+    void setParams(const ScrollParams &params);
+    const ScrollParams &params() const { return _params; }
+
+    int fingers;                // exactly this many fingers in the plane
+    float interactionPlaneZ;    // fingers only count once tip z is below this
+    float deadZone;             // mm/s; slower fingertips are treated as still
+
+    virtual unsigned inputs() const { return FrameHasFingers; }
+    virtual bool processFrame(const FrameSnapshot &frame, GestureHandler &handler);
+    virtual void reset();
+
+private:
+    ScrollEngine *_engine;
+    ScrollParams _params;
+    bool _tracking;
+};
+
+}
+
+#endif
@@ -0,0 +1,281 @@
+//
+//  SharedFrame.cpp
+//  OSXGestureControl
+//
+//  Copyright (c) 2013 Chris Willingham. All rights reserved.
+//
+
+#include "SharedFrame.h"
+
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+
+namespace GestureCore {
+
+static SharedGestureEvent sharedEvent(const GestureEvent &event)
+{
+    SharedGestureEvent shared;
+    shared.type = event.type;
+    shared.direction = event.direction;
+    shared.fingers = event.fingers;
+    shared.magnitude = event.magnitude;
+    shared.avgVelocity = Float3::fromVector(event.avgVelocity);
+    shared.position = Float3::fromVector(event.position);
+    shared.frameId = event.frameId;
+    shared.timestamp = event.timestamp;
+    return shared;
+}
+
+// Seqlock write side: the sequence goes odd, the release fence keeps the
+// data writes from being seen before it, and the release store making it
+// even again keeps them from being seen after.
+static inline uint64_t beginWrite(std::atomic<uint64_t> &sequence)
+{
+    const uint64_t value = sequence.load(std::memory_order_relaxed);
+    sequence.store(value + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    return value;
+}
+
+static inline void endWrite(std::atomic<uint64_t> &sequence, uint64_t value)
+{
+    sequence.store(value + 2, std::memory_order_release);
+}
+
+// Seqlock read side: after reading the data, whether the sequence is still
+// the even value the read started from. The acquire fence keeps the data
+// reads from moving past the second load.
+static inline bool readUnchanged(const std::atomic<uint64_t> &sequence, uint64_t value)
+{
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return (value & 1) == 0 && sequence.load(std::memory_order_relaxed) == value;
+}
+
+//////////////////////////////////////////////////////////////////////////
+//PUBLISHER
+SharedFramePublisher::SharedFramePublisher() : _region(NULL)
+{
+    _name[0] = '\0';
+}
+
+SharedFramePublisher::~SharedFramePublisher()
+{
+    close();
+}
+
+bool SharedFramePublisher::open(const char *name)
+{
+    close();
+    if (strlen(name) >= sizeof(_name)) {
+        return false;
+    }
+    // a fresh region, so a reader still mapping a stale one can't see it
+    // reinitialized under its feet
+    shm_unlink(name);
+    int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0644);
+    if (fd < 0) {
+        return false;
+    }
+    void *data = MAP_FAILED;
+    if (ftruncate(fd, sizeof(SharedFrameRegion)) == 0) {
+        data = mmap(NULL, sizeof(SharedFrameRegion), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        shm_unlink(name);
+        return false;
+    }
+    // ftruncate zero-filled it, which is also every sequence at 0
+    _region = (SharedFrameRegion *)data;
+    memcpy(_region->header.magic, SharedFrameMagic, sizeof(SharedFrameMagic));
+    _region->header.version = SharedFrameVersion;
+    _region->header.regionSize = sizeof(SharedFrameRegion);
+    _region->header.writerOpen.store(1, std::memory_order_release);
+    strcpy(_name, name);
+    return true;
+}
+
+void SharedFramePublisher::close()
+{
+    if (_region == NULL) {
+        return;
+    }
+    _region->header.writerOpen.store(0, std::memory_order_release);
+    munmap(_region, sizeof(SharedFrameRegion));
+    shm_unlink(_name);
+    _region = NULL;
+    _name[0] = '\0';
+}
+
+void SharedFramePublisher::publishFrame(const FrameSnapshot &frame)
+{
+    if (_region == NULL) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(_writeLock);
+    const uint64_t sequence = beginWrite(_region->frameSequence);
+    _region->frame.copyFrom(frame);
+    endWrite(_region->frameSequence, sequence);
+}
+
+void SharedFramePublisher::publishEvent(const GestureEvent &event)
+{
+    if (_region == NULL) {
+        return;
+    }
+    const SharedGestureEvent shared = sharedEvent(event);
+    std::lock_guard<std::mutex> lock(_writeLock);
+    const uint64_t sequence = beginWrite(_region->eventSequence);
+    _region->events[(sequence / 2) % MaxSharedEvents] = shared;
+    endWrite(_region->eventSequence, sequence);
+}
+
+uint64_t SharedFramePublisher::framesPublished() const
+{
+    return _region != NULL ? _region->frameSequence.load(std::memory_order_relaxed) / 2 : 0;
+}
+
+uint64_t SharedFramePublisher::eventsPublished() const
+{
+    return _region != NULL ? _region->eventSequence.load(std::memory_order_relaxed) / 2 : 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+//READER
+SharedFrameReader::SharedFrameReader()
+    : _region(NULL), _frameSequence(0), _nextEvent(0), _missedFrames(0), _missedEvents(0), _tornReads(0)
+{
+}
+
+SharedFrameReader::~SharedFrameReader()
+{
+    close();
+}
+
+bool SharedFrameReader::open(const char *name)
+{
+    close();
+    int fd = shm_open(name, O_RDONLY, 0);
+    if (fd < 0) {
+        return false;
+    }
+    // the publisher may not have sized it yet, and touching a mapping past
+    // the end of the object faults
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(SharedFrameRegion)) {
+        ::close(fd);
+        return false;
+    }
+    void *data = mmap(NULL, sizeof(SharedFrameRegion), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        return false;
+    }
+    const SharedFrameRegion *region = (const SharedFrameRegion *)data;
+    // writerOpen is stored last, so a region mapped before the publisher
+    // filled the header in fails here and the caller tries again later
+    if (region->header.writerOpen.load(std::memory_order_acquire) == 0
+        || memcmp(region->header.magic, SharedFrameMagic, sizeof(SharedFrameMagic)) != 0
+        || region->header.version != SharedFrameVersion || region->header.regionSize != sizeof(SharedFrameRegion)) {
+        munmap(data, sizeof(SharedFrameRegion));
+        return false;
+    }
+    _region = region;
+    // start from what's there now, rounding a write in progress down so
+    // the frame it's writing still counts as new
+    _frameSequence = _region->frameSequence.load(std::memory_order_acquire) & ~(uint64_t)1;
+    _nextEvent = _region->eventSequence.load(std::memory_order_acquire) / 2;
+    _missedFrames = 0;
+    _missedEvents = 0;
+    _tornReads = 0;
+    return true;
+}
+
+void SharedFrameReader::close()
+{
+    if (_region != NULL) {
+        munmap((void *)_region, sizeof(SharedFrameRegion));
+        _region = NULL;
+    }
+}
+
+bool SharedFrameReader::writerOpen() const
+{
+    return _region != NULL && _region->header.writerOpen.load(std::memory_order_acquire) != 0;
+}
+
+void SharedFrameReader::frameRead(uint64_t sequence)
+{
+    if (sequence > _frameSequence) {
+        _missedFrames += (sequence - _frameSequence) / 2 - 1;
+        _frameSequence = sequence;
+    }
+}
+
+SharedReadResult SharedFrameReader::readFrame(FrameBuffer &frame)
+{
+    const uint64_t sequence = beginFrame();
+    if (sequence == 0) {
+        return SharedReadEmpty;
+    }
+    if (sequence == _frameSequence) {
+        return SharedReadUnchanged;
+    }
+    if (sequence & 1) {
+        _tornReads++;
+        return SharedReadTorn;
+    }
+    // into a scratch buffer, so a torn read leaves frame as it was; only
+    // the counts' worth of each array is copied
+    FrameBuffer copy;
+    copy.copyFrom(_region->frame.snapshot());
+    if (!endFrame(sequence)) {
+        return SharedReadTorn;
+    }
+    frame = copy;
+    return SharedReadNew;
+}
+
+uint64_t SharedFrameReader::beginFrame() const
+{
+    return _region->frameSequence.load(std::memory_order_acquire);
+}
+
+bool SharedFrameReader::endFrame(uint64_t sequence)
+{
+    if (!readUnchanged(_region->frameSequence, sequence)) {
+        _tornReads++;
+        return false;
+    }
+    frameRead(sequence);
+    return sequence != 0;
+}
+
+size_t SharedFrameReader::readEvents(SharedGestureEvent *events, size_t capacity)
+{
+    const uint64_t sequence = _region->eventSequence.load(std::memory_order_acquire);
+    if (sequence & 1) {
+        _tornReads++;
+        return 0;
+    }
+    const uint64_t published = sequence / 2;
+    // anything older than the ring has been overwritten
+    const uint64_t first = std::max(_nextEvent, published > MaxSharedEvents ? published - MaxSharedEvents : 0);
+    const size_t count = (size_t)std::min(published - first, (uint64_t)capacity);
+    for (size_t i = 0; i < count; i++) {
+        events[i] = _region->events[(first + i) % MaxSharedEvents];
+    }
+    if (!readUnchanged(_region->eventSequence, sequence)) {
+        _tornReads++;
+        return 0;
+    }
+    _missedEvents += first - _nextEvent;
+    _nextEvent = first + count;
+    return count;
+}
+
+}
@@ -0,0 +1,176 @@
+//
+//  SharedFrame.h
+//  OSXGestureControl
+//
+//  Copyright (c) 2013 Chris Willingham. All rights reserved.
+//
+//  Publishes the latest frame and recent gesture events in a POSIX shared
+//  memory region, so other local processes (visualisers, loggers, games)
+//  can follow the sensor without a socket or a second Leap connection.
+//
+//  The frame and the event ring are each guarded by a seqlock: a sequence
+//  number that's odd while the one writer is changing the data and goes up
+//  by two for every publication. A reader copies the data between two loads
+//  of the sequence and keeps the copy only if they match, so readers never
+//  block, never write to the region and can't slow the writer down however
+//  many of them there are. The sequence also counts publications, which is
+//  how a reader that polls too slowly finds out how many it missed.
+//
+//  Region layout (native byte order, mapped at the same size by everyone):
+//
+//    SharedFrameHeader
+//    frameSequence, then the latest FrameBuffer
+//    eventSequence, then the last MaxSharedEvents SharedGestureEvents
+//
+
+#ifndef OSXGestureControl_SharedFrame_h
+#define OSXGestureControl_SharedFrame_h
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <mutex>
+#include "FrameSnapshot.h"
+#include "GestureRecognizer.h"
+
+namespace GestureCore {
+
+// Short enough for macOS, which limits shm names to 31 characters.
+static const char SharedFrameName[] = "/GestureControl.frame";
+static const char SharedFrameMagic[4] = { 'L', 'P', 'S', 'H' };
+static const uint32_t SharedFrameVersion = 1;
+
+enum { MaxSharedEvents = 64 };
+
+struct SharedFrameHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t regionSize;
+    std::atomic<uint32_t> writerOpen;   // 0 once the publisher has closed
+};
+
+// GestureEvent as plain data.
+struct SharedGestureEvent {
+    int32_t type;           // GestureType
+    int32_t direction;      // Direction
+    int32_t fingers;
+    float magnitude;
+    Float3 avgVelocity;
+    Float3 position;
+    int64_t frameId;
+    int64_t timestamp;
+};
+
+// The atomics are shared between processes, which only works if they're
+// lock-free.
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2 && ATOMIC_INT_LOCK_FREE == 2, "shared region needs lock-free atomics");
+
+struct SharedFrameRegion {
+    SharedFrameHeader header;
+    // each on its own cache line, so polling one doesn't bounce the other
+    alignas(64) std::atomic<uint64_t> frameSequence;
+    FrameBuffer frame;
+    alignas(64) std::atomic<uint64_t> eventSequence;
+    SharedGestureEvent events[MaxSharedEvents];   // the nth event is at n % MaxSharedEvents
+};
+
+class SharedFramePublisher
+{
+public:
+    SharedFramePublisher();
+    ~SharedFramePublisher();
+
+    // Creates the region, replacing any a crashed publisher left behind.
+    bool open(const char *name = SharedFrameName);
+    // Unmaps and unlinks the region.
+    void close();
+    bool isOpen() const { return _region != NULL; }
+
+    // Both can be called from any thread; writers are serialized among
+    // themselves, which readers never wait on.
+    void publishFrame(const FrameSnapshot &frame);
+    void publishEvent(const GestureEvent &event);
+
+    uint64_t framesPublished() const;
+    uint64_t eventsPublished() const;
+
+private:
+    SharedFramePublisher(const SharedFramePublisher &);
+    SharedFramePublisher &operator=(const SharedFramePublisher &);
+
+    SharedFrameRegion *_region;
+    char _name[32];
+    std::mutex _writeLock;
+};
+
+enum SharedReadResult {
+    SharedReadNew,          // a frame newer than the last one read
+    SharedReadUnchanged,    // nothing published since the last read
+    SharedReadEmpty,        // nothing published at all yet
+    SharedReadTorn          // the writer was in the middle of it; poll again
+};
+
+// One reader's view of the region. Every read is a single attempt of
+// bounded length that reports a torn read rather than retrying, so polling
+// is wait-free. A reader isn't shared between threads.
+class SharedFrameReader
+{
+public:
+    SharedFrameReader();
+    ~SharedFrameReader();
+
+    // Maps the region read-only. Returns false if there's no publisher or
+    // the region is from a different version. Frames and events published
+    // before open don't count as missed.
+    bool open(const char *name = SharedFrameName);
+    void close();
+    bool isOpen() const { return _region != NULL; }
+
+    // False once the publisher has closed the region. A publisher that
+    // crashed can't say so, so a reader whose frames stop coming may want
+    // to reopen anyway, in case a new one has started.
+    bool writerOpen() const;
+
+    // Copies the latest frame into frame, which is only changed on
+    // SharedReadNew.
+    SharedReadResult readFrame(FrameBuffer &frame);
+
+    // Reading in place, without the copy: take a sequence with beginFrame(),
+    // read what's needed from frame(), then trust what was read only if
+    // endFrame(sequence) is true. Until then the data may be half old, half
+    // new (counts are always within the buffer's capacities, though), so
+    // it's for short reads such as a palm position.
+    uint64_t beginFrame() const;
+    const FrameBuffer &frame() const { return _region->frame; }
+    bool endFrame(uint64_t sequence);
+
+    // Copies up to capacity events published since the last call, oldest
+    // first. Returns 0 on a torn read, in which case nothing is consumed.
+    // Events that were overwritten before they could be read are counted in
+    // missedEvents().
+    size_t readEvents(SharedGestureEvent *events, size_t capacity);
+
+    // Frames published between two successful reads that were never seen,
+    // events lost to the ring wrapping, and reads that had to be dropped.
+    uint64_t missedFrames() const { return _missedFrames; }
+    uint64_t missedEvents() const { return _missedEvents; }
+    uint64_t tornReads() const { return _tornReads; }
+
+private:
+    SharedFrameReader(const SharedFrameReader &);
+    SharedFrameReader &operator=(const SharedFrameReader &);
+
+    // records a successfully read frame sequence
+    void frameRead(uint64_t sequence);
+
+    const SharedFrameRegion *_region;
+    uint64_t _frameSequence;    // last frame read, even
+    uint64_t _nextEvent;        // index of the next event to read
+    uint64_t _missedFrames;
+    uint64_t _missedEvents;
+    uint64_t _tornReads;
+};
+
+}
+
+#endif
@@ -0,0 +1,283 @@
+//
+//  TemplateRecognizer.cpp
+//  OSXGestureControl
+//
+//  Copyright (c) 2013 Chris Willingham. All rights reserved.
+//
+
+#include "TemplateRecognizer.h"
+
+#include <algorithm>
+
+namespace GestureCore {
+
+//////////////////////////////////////////////////////////////////////////
+//MATCHING
+bool normalizeTrajectory(const Leap::Vector *points, size_t count, Leap::Vector *out)
+{
+    float total = 0;
+    for (size_t i = 1; i < count; i++) {
+        total += points[i].distanceTo(points[i - 1]);
+    }
+    if (count < 2 || total <= 0) {
+        return false;
+    }
+
+    // resample to evenly spaced points along the path
+    const float interval = total / (TemplatePoints - 1);
+    int n = 0;
+    out[n++] = points[0];
+    Leap::Vector previous = points[0];
+    float travelled = 0;
+    for (size_t i = 1; i < count && n < TemplatePoints; i++) {
+        float step = previous.distanceTo(points[i]);
+        while (step > 0 && travelled + step >= interval && n < TemplatePoints) {
+            const float t = (interval - travelled) / step;
+            previous = previous + (points[i] - previous) * t;
+            out[n++] = previous;
+            step = previous.distanceTo(points[i]);
+            travelled = 0;
+        }
+        travelled += step;
+        previous = points[i];
+    }
+    // rounding can leave the last point or so unfilled
+    while (n < TemplatePoints) {
+        out[n++] = points[count - 1];
+    }
+
+    const Leap::Vector centroid = Leap::VectorBatch::mean(out, TemplatePoints);
+    const Leap::Vector extent = Leap::VectorBatch::max(out, TemplatePoints) - Leap::VectorBatch::min(out, TemplatePoints);
+    const float size = std::max(extent.x, std::max(extent.y, extent.z));
+    if (size <= 0) {
+        return false;
+    }
+    for (int i = 0; i < TemplatePoints; i++) {
+        out[i] = (out[i] - centroid) / size;
+    }
+    return true;
+}
+
+float dtwDistance(const Leap::Vector *a, const Leap::Vector *b, int band, float limit)
+{
+    const float infinity = FLT_MAX;
+    float rows[2][TemplatePoints + 1];
+    float *previous = rows[0];
+    float *current = rows[1];
+    std::fill(previous, previous + TemplatePoints + 1, infinity);
+    previous[0] = 0;
+    for (int i = 1; i <= TemplatePoints; i++) {
+        std::fill(current, current + TemplatePoints + 1, infinity);
+        float rowMinimum = infinity;
+        const int first = std::max(1, i - band);
+        const int last = std::min<int>(TemplatePoints, i + band);
+        for (int j = first; j <= last; j++) {
+            const float best = std::min(previous[j - 1], std::min(previous[j], current[j - 1]));
+            current[j] = a[i - 1].distanceTo(b[j - 1]) + best;
+            rowMinimum = std::min(rowMinimum, current[j]);
+        }
+        // every warping path crosses this row, so none can come in under the limit
+        if (rowMinimum >= limit) {
+            return rowMinimum;
+        }
+        std::swap(previous, current);
+    }
+    return previous[TemplatePoints];
+}
+
+// Sum of each query point's distance to the template's envelope at that
+// point, which DTW within the same band can never beat.
+static float keoghLowerBound(const Leap::Vector *query, const TrajectoryTemplate &trajectory, float limit)
+{
+    float bound = 0;
+    for (int i = 0; i < TemplatePoints && bound < limit; i++) {
+        const Leap::Vector &q = query[i];
+        const Leap::Vector &lower = trajectory.lower[i];
+        const Leap::Vector &upper = trajectory.upper[i];
+        const Leap::Vector outside(std::max(0.0f, std::max(lower.x - q.x, q.x - upper.x)),
+                                   std::max(0.0f, std::max(lower.y - q.y, q.y - upper.y)),
+                                   std::max(0.0f, std::max(lower.z - q.z, q.z - upper.z)));
+        bound += outside.magnitude();
+    }
+    return bound;
+}
+
+//////////////////////////////////////////////////////////////////////////
+//RECOGNIZER
+TemplateRecognizer::TemplateRecognizer(SwipeGate &gate)
+    : windowMicros(DefaultTemplateWindowMicros), minPathLength(DefaultTemplateMinPathLength), minSpeed(DefaultTemplateMinSpeed),
+      matchThreshold(DefaultTemplateMatchThreshold), _gate(gate), _band(3)
+{
+    reset();
+}
+
+void TemplateRecognizer::setBand(int band)
+{
+    _band = std::max(0, band);
+    for (size_t i = 0; i < _templates.size(); i++) {
+        updateEnvelope(_templates[i]);
+    }
+}
+
+void TemplateRecognizer::updateEnvelope(TrajectoryTemplate &trajectory) const
+{
+    for (int i = 0; i < TemplatePoints; i++) {
+        const int first = std::max(0, i - _band);
+        const int count = std::min<int>(TemplatePoints - 1, i + _band) - first + 1;
+        trajectory.lower[i] = Leap::VectorBatch::min(trajectory.points + first, count);
+        trajectory.upper[i] = Leap::VectorBatch::max(trajectory.points + first, count);
+    }
+}
+
+bool TemplateRecognizer::addTemplate(const Leap::Vector *points, size_t count, GestureType type, Direction direction)
+{
+    TrajectoryTemplate trajectory;
+    if (!normalizeTrajectory(points, count, trajectory.points)) {
+        return false;
+    }
+    trajectory.type = type;
+    trajectory.direction = direction;
+    updateEnvelope(trajectory);
+    _templates.push_back(trajectory);
+    return true;
+}
+
+void TemplateRecognizer::addSwipeTemplates()
+{
+    const Direction directions[] = { Up, Down, Left, Right };
+    const Leap::Vector ends[] = { Leap::Vector(0, 1, 0), Leap::Vector(0, -1, 0), Leap::Vector(-1, 0, 0), Leap::Vector(1, 0, 0) };
+    for (int i = 0; i < 4; i++) {
+        const Leap::Vector line[2] = { Leap::Vector(), ends[i] * 100 };
+        addTemplate(line, 2, SWIPE_GESTURE, directions[i]);
+    }
+}
+
+size_t TemplateRecognizer::window(Leap::Vector *out, size_t max) const
+{
+    const size_t count = std::min(max, _count);
+    for (size_t i = 0; i < count; i++) {
+        out[i] = _samples[(_first + i) % MaxTrajectorySamples];
+    }
+    return count;
+}
+
+void TemplateRecognizer::reset()
+{
+    _handId = -1;
+    _first = 0;
+    _count = 0;
+    _pathLength = 0;
+}
+
+void TemplateRecognizer::push(const Leap::Vector &position, int64_t timestamp)
+{
+    if (_count == MaxTrajectorySamples) {
+        popOldest();
+    }
+    if (_count > 0) {
+        _pathLength += position.distanceTo(_samples[(_first + _count - 1) % MaxTrajectorySamples]);
+    }
+    const size_t index = (_first + _count) % MaxTrajectorySamples;
+    _samples[index] = position;
+    _times[index] = timestamp;
+    _count++;
+}
+
+void TemplateRecognizer::popOldest()
+{
+    if (_count > 1) {
+        _pathLength -= _samples[_first].distanceTo(_samples[(_first + 1) % MaxTrajectorySamples]);
+    }
+    _first = (_first + 1) % MaxTrajectorySamples;
+    _count--;
+    if (_count <= 1) {
+        _pathLength = 0;
+    }
+}
+
+int TemplateRecognizer::match(const Leap::Vector *query, float &distance) const
+{
+    float best = matchThreshold * TemplatePoints;
+    int bestIndex = -1;
+    for (size_t i = 0; i < _templates.size(); i++) {
+        const TrajectoryTemplate &trajectory = _templates[i];
+        if (keoghLowerBound(query, trajectory, best) >= best) {
+            continue;
+        }
+        const float d = dtwDistance(query, trajectory.points, _band, best);
+        if (d < best) {
+            best = d;
+            bestIndex = (int)i;
+        }
+    }
+    distance = best / TemplatePoints;
+    return bestIndex;
+}
+
+bool TemplateRecognizer::processFrame(const FrameSnapshot &frame, GestureHandler &handler)
+{
+    // follow one hand; start over when it goes
+    const HandSnapshot *hand = NULL;
+    for (uint32_t h = 0; h < frame.handCount && hand == NULL; h++) {
+        hand = frame.hands[h].id == _handId ? &frame.hands[h] : NULL;
+    }
+    if (hand == NULL) {
+        reset();
+        if (frame.handCount == 0) {
+            return false;
+        }
+        hand = &frame.hands[0];
+        _handId = hand->id;
+    }
+
+    push(hand->palmPosition.toVector(), frame.timestamp);
+    while (_count > 1 && frame.timestamp - _times[_first] > windowMicros) {
+        popOldest();
+    }
+    // a still lead-in isn't part of the stroke, and dropping it keeps slow
+    // drift from ever adding up to minPathLength
+    while (_count > 2) {
+        const size_t second = (_first + 1) % MaxTrajectorySamples;
+        const int64_t step = _times[second] - _times[_first];
+        if (step > 0 && _samples[_first].distanceTo(_samples[second]) * 1e6f / step >= minSpeed / 4) {
+            break;
+        }
+        popOldest();
+    }
+    if (_templates.empty() || _pathLength < minPathLength) {
+        return true;
+    }
+    const int64_t duration = frame.timestamp - _times[_first];
+    if (duration <= 0 || _pathLength * 1e6f / duration < minSpeed) {
+        return true;
+    }
+
+    Leap::Vector samples[MaxTrajectorySamples];
+    Leap::Vector query[TemplatePoints];
+    const size_t count = window(samples, MaxTrajectorySamples);
+    float distance;
+    const int index = normalizeTrajectory(samples, count, query) ? match(query, distance) : -1;
+    if (index < 0) {
+        return true;
+    }
+
+    const TrajectoryTemplate &trajectory = _templates[index];
+    GestureEvent event(trajectory.type, frame);
+    event.direction = trajectory.direction;
+    event.avgVelocity = hand->palmVelocity.toVector();
+    event.position = hand->palmPosition.toVector();
+    event.magnitude = distance;
+    for (uint32_t i = 0; i < frame.pointableCount; i++) {
+        event.fingers += frame.pointables.handIds[i] == hand->id && (frame.pointables.flags[i] & PointableIsFinger);
+    }
+    // the matched stroke is used up either way
+    const int32_t handId = _handId;
+    reset();
+    _handId = handId;
+    if (trajectory.type != SWIPE_GESTURE || _gate.tryFire(trajectory.direction, frame.timestamp)) {
+        handler.onGesture(event);
+    }
+    return true;
+}
+
+}
@@ -0,0 +1,111 @@
+//
+//  TemplateRecognizer.h
+//  OSXGestureControl
+//
+//  Copyright (c) 2013 Chris Willingham. All rights reserved.
+//
+//  Trajectory matching: keeps the last windowMicros of palm positions and
+//  compares them against recorded templates with dynamic time warping.
+//
+//  Both sides are normalized the same way before matching: resampled to
+//  TemplatePoints evenly spaced along the path (so pauses and speed don't
+//  matter), centered on the centroid and scaled so the largest side of the
+//  bounding box is 1. Orientation is kept, so a left and a right swipe are
+//  different templates. Templates are tried cheapest first: an LB_Keogh
+//  lower bound discards most of them, and the DTW itself gives up as soon
+//  as it can't beat the best match so far.
+//
+
+#ifndef OSXGestureControl_TemplateRecognizer_h
+#define OSXGestureControl_TemplateRecognizer_h
+
+#include <stddef.h>
+#include <vector>
+#include "GestureRecognizer.h"
+#include "Recognizers.h"
+
+namespace GestureCore {
+
+enum {
+    TemplatePoints = 32,
+    MaxTrajectorySamples = 128
+};
+
+struct TrajectoryTemplate {
+    GestureType type;
+    Direction direction;
+    Leap::Vector points[TemplatePoints];
+    // per point bounding box of the points within the warping band
+    Leap::Vector lower[TemplatePoints];
+    Leap::Vector upper[TemplatePoints];
+};
+
+// Fills out[TemplatePoints] with the normalized path. Returns false for a
+// path with no length.
+bool normalizeTrajectory(const Leap::Vector *points, size_t count, Leap::Vector *out);
+
+// DTW distance between two normalized paths, with warping limited to band
+// points either side of the diagonal. Returns a value >= limit as soon as
+// the result is known to be at least limit.
+float dtwDistance(const Leap::Vector *a, const Leap::Vector *b, int band, float limit);
+
+// Defaults of TemplateRecognizer's fields, shared with GestureConfig.
+static const int64_t DefaultTemplateWindowMicros = 600000;
+static const float DefaultTemplateMinPathLength = 80;   // mm
+static const float DefaultTemplateMinSpeed = 500;       // mm/s
+static const float DefaultTemplateMatchThreshold = 0.08f;
+
+class TemplateRecognizer : public GestureRecognizer
+{
+public:
+    // Swipe templates go through gate like the other swipe recognizers.
+    explicit TemplateRecognizer(SwipeGate &gate);
+
+    int64_t windowMicros;   // how much trajectory is matched
+    float minPathLength;    // mm; shorter windows aren't matched
+    float minSpeed;         // mm/s average over the stroke; slower is drift
+    float matchThreshold;   // mean distance per point, in normalized units
+
+    // DTW warping band, in points either side of the diagonal.
+    void setBand(int band);
+    int band() const { return _band; }
+
+    // Adds a template from a recorded path, e.g. one taken from window().
+    // Returns false if the path is degenerate.
+    bool addTemplate(const Leap::Vector *points, size_t count, GestureType type, Direction direction);
+
+    // Straight line templates for the four swipe directions.
+    void addSwipeTemplates();
+
+    void clearTemplates() { _templates.clear(); }
+    size_t templateCount() const { return _templates.size(); }
+
+    // Copies out the current window of palm positions, oldest first.
+    size_t window(Leap::Vector *out, size_t max) const;
+
+    virtual unsigned inputs() const { return FrameHasHands; }
+    virtual bool processFrame(const FrameSnapshot &frame, GestureHandler &handler);
+    virtual void reset();
+
+private:
+    void updateEnvelope(TrajectoryTemplate &trajectory) const;
+    void push(const Leap::Vector &position, int64_t timestamp);
+    void popOldest();
+    // index into _templates of the best match under the threshold, or -1
+    int match(const Leap::Vector *query, float &distance) const;
+
+    SwipeGate &_gate;
+    int _band;
+    std::vector<TrajectoryTemplate> _templates;
+
+    int32_t _handId;
+    Leap::Vector _samples[MaxTrajectorySamples];
+    int64_t _times[MaxTrajectorySamples];
+    size_t _first;
+    size_t _count;
+    float _pathLength;
+};
+
+}
+
+#endif
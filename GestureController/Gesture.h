@@ -8,18 +8,7 @@
 
 #import <Foundation/Foundation.h>
 #import "include/LeapObjectiveC.h"
-
-typedef enum {
-    Up,
-    Down,
-    Left,
-    Right
-} Direction;
-
-typedef enum {
-    SCROLL_GESTURE,
-    SWIPE_GESTURE
-}GestureType;
+#import "Core/GestureTypes.h"
 
 @interface Gesture : NSObject
 
@@ -27,7 +16,10 @@ typedef enum {
 
 @property (nonatomic) NSInteger fingers;
 @property (nonatomic) LeapVector *avgVelocity;
-@property (nonatomic) GestureType *type;
+@property (nonatomic) GestureType type;
+// LatencyTrace clock readings; 0 when tracing is off.
+@property (nonatomic) int64_t receivedNanos;
+@property (nonatomic) int64_t detectedNanos;
 
 
 -(id) initWithDirection:(Direction)dir andFingers:(NSInteger)count andVelocity:(LeapVector*)vector;
@@ -14,11 +14,14 @@
 @synthesize fingers;
 @synthesize avgVelocity;
 @synthesize type;
+@synthesize receivedNanos;
+@synthesize detectedNanos;
 
 -(id)initWithDirection:(Direction)dir andFingers:(NSInteger)count andVelocity:(LeapVector*)vector{
     if(self = [super init]){
         self.direction = dir;
         self.fingers = count;
+        self.type = SWIPE_GESTURE;
         self.avgVelocity = vector;
     }
     return self;
@@ -28,6 +31,7 @@
     if(self = [super init]){
         self.direction = dir;
         self.fingers = count;
+        self.type = SWIPE_GESTURE;
     }
     return self;
 }
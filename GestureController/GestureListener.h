@@ -10,6 +10,8 @@
 #import "include/LeapObjectiveC.h"
 #import "Gesture.h"
 
+@class ActionQueue;
+
 typedef void (^OnGestureEvent) (Gesture *g);
 
 @interface GestureListener : NSObject<LeapListener>{
@@ -20,8 +22,40 @@ typedef void (^OnGestureEvent) (Gesture *g);
 
 - (void) setGestureEvent:(OnGestureEvent)callback;
 
-- (void) gestureDetected:(Gesture*)gesture;
+// Scrolls continuously while scroll.fingers fingers (2 unless configured)
+// are in the interaction plane, through actionQueue's scroll engine. Call
+// before run.
+- (void) scrollWith:(ActionQueue*)actionQueue;
+
+// Loads detector thresholds from a "name = value" file, see
+// Core/GestureConfig.h. Can be called again at any time to reload; the
+// detector thread picks the new settings up before its next frame.
+- (BOOL) loadConfig:(NSString*)path;
+
+// Loads the config file like loadConfig: and reloads it every time it
+// changes on disk, see Core/ConfigWatcher.h.
+- (BOOL) watchConfig:(NSString*)path;
+
+// Publishes every frame the detector sees, and every gesture it reports,
+// to other local processes through the POSIX shared memory region name,
+// or GestureCore::SharedFrameName for nil. See Core/SharedFrame.h. Call
+// before run.
+- (BOOL) publishFrames:(NSString*)name;
+
+// Appends every frame the detector sees to a GestureCore frame recording
+// at path, see Core/FrameRecording.h.
+- (BOOL) startRecording:(NSString*)path;
+
+- (void) stopRecording;
+
+// Frames the detector thread fell too far behind to see.
+- (uint64_t) droppedFrames;
+
+// Turns on GestureCore::LatencyTrace and, for a positive interval, logs
+// latencyReport every interval seconds.
+- (void) traceLatencyEvery:(NSTimeInterval)interval;
 
-- (void) handleSwipe: (LeapSwipeGesture*)swipe;
+// Per stage latency percentiles from the Leap callback to the posted event.
+- (NSString*) latencyReport;
 
 @end
@@ -0,0 +1,330 @@
+//
+//  LeapTest.m
+//  LEAPTest2
+//
+//  Created by Chris Willingham on 1/28/13.
+//  Copyright (c) 2013 Chris Willingham. All rights reserved.
+//
+
+#import "GestureListener.h"
+#import "ActionQueue.h"
+#import "Gesture.h"
+#include "include/Leap.h"
+#include <mutex>
+#include <thread>
+#include "Core/ConfigWatcher.h"
+#include "Core/FrameRecording.h"
+#include "Core/FrameRing.h"
+#include "Core/GestureDetector.h"
+#include "Core/LatencyTrace.h"
+#include "Core/LeapFrameCapture.h"
+#include "Core/SharedFrame.h"
+
+@interface GestureListener ()
+
+- (void)dispatchGesture:(Gesture *)gesture;
+- (void)detectFrames;
+
+@end
+
+// Forwards detections from the C++ core back to the Objective-C listener.
+class ListenerGestureHandler : public GestureCore::GestureHandler
+{
+public:
+    ListenerGestureHandler() : _listener(nil), _publisher(NULL) {}
+
+    virtual void onGesture(const GestureCore::GestureEvent &event)
+    {
+        if (_publisher != NULL) {
+            _publisher->publishEvent(event);
+        }
+        LeapVector *avgVelocity = [[LeapVector alloc] initWithX:event.avgVelocity.x y:event.avgVelocity.y z:event.avgVelocity.z];
+        Gesture *gesture = [[Gesture alloc] initWithDirection:event.direction andFingers:event.fingers andVelocity:avgVelocity];
+        gesture.type = event.type;
+        gesture.receivedNanos = event.receivedNanos;
+        gesture.detectedNanos = event.receivedNanos != 0 ? GestureCore::LatencyTrace::shared().begin() : 0;
+        [_listener dispatchGesture:gesture];
+    }
+
+    void setListener(GestureListener *listener)
+    {
+        _listener = listener;
+    }
+
+    void setPublisher(GestureCore::SharedFramePublisher *publisher)
+    {
+        _publisher = publisher;
+    }
+
+private:
+    __unsafe_unretained GestureListener *_listener;
+    GestureCore::SharedFramePublisher *_publisher;
+};
+
+// Runs on the Leap library's own thread: copies each frame straight into
+// the ring, no Objective-C objects and no hop to the main thread.
+class SnapshotListener : public Leap::Listener
+{
+public:
+    // Frames the library delivered without an onFrame (it skips callbacks
+    // while the last one is still running) are picked up from the
+    // controller's history, up to this many at once.
+    enum { CatchUpFrames = 16 };
+
+    SnapshotListener(GestureCore::FrameRing &ring, GestureCore::FrameSignal &signal) : _ring(ring), _signal(signal) {}
+
+    virtual void onFrame(const Leap::Controller &leapController)
+    {
+        GestureCore::LatencyTrace &trace = GestureCore::LatencyTrace::shared();
+        const int64_t received = trace.begin();
+        const int count = GestureCore::framesSince(leapController, _lastCaptured, _catchUp, CatchUpFrames);
+        for (int history = count - 1; history >= 0; history--) {
+            const Leap::Frame &frame = _catchUp[history];
+            GestureCore::FrameBuffer &buffer = _ring.beginWrite();
+            if (history == CatchUpFrames - 1 && _lastCaptured.isValid()) {
+                // there may be frames between the last one captured and the
+                // oldest one still in reach; keep their SDK gestures at least
+                GestureCore::captureFrame(frame, _lastCaptured, buffer);
+            } else {
+                GestureCore::captureFrame(frame, buffer);
+            }
+            buffer.receivedNanos = received;
+            _ring.commitWrite();
+            _lastCaptured = frame;
+        }
+        if (count > 0) {
+            trace.end(GestureCore::TraceCapture, received);
+            _signal.notify();
+        }
+    }
+
+private:
+    GestureCore::FrameRing &_ring;
+    GestureCore::FrameSignal &_signal;
+    Leap::Frame _lastCaptured;
+    // filled by framesSince, newest first; a member so onFrame doesn't
+    // construct CatchUpFrames empty frames every call
+    Leap::Frame _catchUp[CatchUpFrames];
+};
+
+@implementation GestureListener{
+    LeapController *controller;
+    OnGestureEvent onGesture;
+    GestureCore::GestureDetector detector;
+    GestureCore::ConfigStore *configStore;
+    GestureCore::ConfigWatcher *configWatcher;
+    ListenerGestureHandler gestureHandler;
+    GestureCore::FrameRing *frameRing;
+    GestureCore::FrameSignal frameSignal;
+    SnapshotListener *snapshotListener;
+    std::thread detectorThread;
+    std::atomic<bool> detecting;
+    std::mutex recorderLock;
+    std::atomic<bool> recording;
+    GestureCore::FrameRecorder recorder;
+    GestureCore::SharedFramePublisher publisher;
+}
+
+-(id)init{
+    if(self = [super init]){
+        gestureHandler.setListener(self);
+        detector.setHandler(&gestureHandler);
+        configStore = new GestureCore::ConfigStore(detector.config());
+        configWatcher = new GestureCore::ConfigWatcher(*configStore);
+        frameRing = new GestureCore::FrameRing();
+        snapshotListener = new SnapshotListener(*frameRing, frameSignal);
+        detecting = false;
+        recording = false;
+    }
+    return self;
+}
+
+-(void)dealloc{
+    if (controller != nil) {
+        ((Leap::Controller *)[controller interfaceController])->removeListener(*snapshotListener);
+    }
+    if (detecting) {
+        detecting = false;
+        frameSignal.notify();
+        detectorThread.join();
+    }
+    delete configWatcher;
+    delete snapshotListener;
+    delete frameRing;
+    delete configStore;
+}
+
+- (void) run{
+    controller = [[LeapController alloc] init];
+    [controller addListener:self];
+    detecting = true;
+    // dealloc joins the thread, so it doesn't need to keep self alive
+    __unsafe_unretained GestureListener *listener = self;
+    detectorThread = std::thread([listener]{ [listener detectFrames]; });
+    ((Leap::Controller *)[controller interfaceController])->addListener(*snapshotListener);
+    NSLog(@"running");
+    [[NSRunLoop currentRunLoop] run]; // required for performSelectorOnMainThread:withObject
+}
+
+// Detector thread: drains the ring oldest frame first.
+- (void) detectFrames{
+    GestureCore::FrameRingSource source(*frameRing);
+    GestureCore::FrameSnapshot frame;
+    GestureCore::LatencyTrace &trace = GestureCore::LatencyTrace::shared();
+    // the only reader, so opening can't fail
+    GestureCore::ConfigReader config;
+    config.open(*configStore);
+    while (detecting) {
+        // the timeout only matters if a wakeup was lost, see FrameSignal
+        frameSignal.wait(std::chrono::milliseconds(5));
+        if (config.update()) {
+            detector.setConfig(config.config());
+        }
+        @autoreleasepool {
+            while (source.nextFrame(frame)) {
+                trace.end(GestureCore::TraceQueue, frame.receivedNanos);
+                if (recording) {
+                    std::lock_guard<std::mutex> lock(recorderLock);
+                    recorder.write(frame);
+                }
+                // before detection, so other processes don't wait on it
+                if (publisher.isOpen()) {
+                    publisher.publishFrame(frame);
+                }
+                const int64_t detectStart = frame.receivedNanos != 0 ? trace.begin() : 0;
+                detector.processFrame(frame);
+                trace.end(GestureCore::TraceDetect, detectStart);
+            }
+        }
+    }
+}
+
+- (uint64_t) droppedFrames{
+    return frameRing->dropped();
+}
+
+-(void) traceLatencyEvery:(NSTimeInterval)interval{
+    GestureCore::LatencyTrace::shared().setEnabled(true);
+    if (interval <= 0) {
+        return;
+    }
+    __weak GestureListener *listener = self;
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(interval * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
+        GestureListener *strongListener = listener;
+        if (strongListener != nil) {
+            NSLog(@"Latency:\n%@", [strongListener latencyReport]);
+            [strongListener traceLatencyEvery:interval];
+        }
+    });
+}
+
+-(NSString *) latencyReport{
+    return [NSString stringWithUTF8String:GestureCore::LatencyTrace::shared().report().c_str()];
+}
+
+- (void)setGestureEvent:(OnGestureEvent)callback{
+    onGesture = callback;
+}
+
+#pragma mark - SampleListener Callbacks
+
+- (void)onInit:(NSNotification *)notification
+{
+    NSLog(@"Initialized");
+}
+
+- (void)onConnect:(NSNotification *)notification;
+{
+    NSLog(@"Connected");
+    LeapController *aController = (LeapController *)[notification object];
+//    [aController enableGesture:LEAP_GESTURE_TYPE_CIRCLE enable:YES];
+//    [aController enableGesture:LEAP_GESTURE_TYPE_KEY_TAP enable:YES];
+//    [aController enableGesture:LEAP_GESTURE_TYPE_SCREEN_TAP enable:YES];
+    [aController enableGesture:LEAP_GESTURE_TYPE_SWIPE enable:YES];
+}
+
+- (void)onDisconnect:(NSNotification *)notification;
+{
+    NSLog(@"Disconnected");
+}
+
+- (void)onExit:(NSNotification *)notification;
+{
+    NSLog(@"Exited");
+}
+
+-(void) scrollWith:(ActionQueue *)actionQueue{
+    GestureCore::ScrollEngine *engine = (GestureCore::ScrollEngine *)[actionQueue scrollEngine];
+    detector.scroll().setEngine(engine);
+    detector.setEnabled(&detector.scroll(), engine != NULL);
+}
+
+-(BOOL) loadConfig:(NSString *)path{
+    int line = 0;
+    if (!configStore->loadFile([path fileSystemRepresentation], &line)) {
+        if (line > 0) {
+            NSLog(@"Could not load gesture config %@: bad setting on line %d", path, line);
+        } else {
+            NSLog(@"Could not read gesture config %@", path);
+        }
+        return NO;
+    }
+    NSLog(@"Loaded gesture config %@ (version %llu)", path, (unsigned long long)configStore->version());
+    return YES;
+}
+
+-(BOOL) watchConfig:(NSString *)path{
+    if (!configWatcher->start([path fileSystemRepresentation])) {
+        NSLog(@"Could not load gesture config %@ (line %d), watching it for changes", path, configWatcher->lastErrorLine());
+        return NO;
+    }
+    NSLog(@"Watching gesture config %@", path);
+    return YES;
+}
+
+-(BOOL) publishFrames:(NSString *)name{
+    if (name == nil) {
+        name = [NSString stringWithUTF8String:GestureCore::SharedFrameName];
+    }
+    if (!publisher.open([name UTF8String])) {
+        NSLog(@"Could not publish frames to shared memory %@", name);
+        return NO;
+    }
+    gestureHandler.setPublisher(&publisher);
+    NSLog(@"Publishing frames to shared memory %@", name);
+    return YES;
+}
+
+-(BOOL) startRecording:(NSString *)path{
+    std::lock_guard<std::mutex> lock(recorderLock);
+    if (!recorder.open([path fileSystemRepresentation])) {
+        NSLog(@"Could not record frames to %@", path);
+        return NO;
+    }
+    recording = true;
+    NSLog(@"Recording frames to %@", path);
+    return YES;
+}
+
+-(void) stopRecording{
+    std::lock_guard<std::mutex> lock(recorderLock);
+    recording = false;
+    if (recorder.isOpen()) {
+        NSLog(@"Recorded %lu frames", (unsigned long)recorder.framesWritten());
+        recorder.close();
+    }
+}
+
+// Called on the detector thread; the gesture callback keeps running on
+// the main thread as before.
+-(void) dispatchGesture:(Gesture *)gesture{
+    dispatch_async(dispatch_get_main_queue(), ^{
+        GestureCore::LatencyTrace::shared().end(GestureCore::TraceDispatch, [gesture detectedNanos]);
+        if (onGesture != nil) {
+            onGesture(gesture);
+        }
+    });
+}
+
+
+@end
@@ -13,6 +13,19 @@
 #include <iostream>
 #include <sstream>
 #include <float.h>
+#include <stddef.h>
+
+// Vector batch kernels use SSE on x86 and NEON on ARM. Define
+// LEAP_MATH_NO_SIMD to force the scalar path.
+#if !defined(LEAP_MATH_NO_SIMD)
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define LEAP_MATH_SSE 1
+#include <xmmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define LEAP_MATH_NEON 1
+#include <arm_neon.h>
+#endif
+#endif
 
 namespace Leap {
 
@@ -737,6 +750,284 @@ struct Matrix
   Vector origin;
 };
 
+/**
+ *  The VectorBatch struct provides allocation-free reductions over contiguous
+ * arrays of Vector, such as the tip positions or velocities of every pointable
+ * in a frame.
+ *
+ * The masked variants take one byte per vector and only consider vectors
+ * whose mask byte is non-zero; use VectorBatch::select() to build a mask from
+ * a predicate. Reductions over an empty selection return the zero vector.
+ *
+ * Four vectors at a time are processed as three 4-wide loads, so the arrays
+ * need no particular alignment or padding.
+ */
+struct VectorBatch {
+  /** The component-wise sum of the vectors. */
+  static Vector sum(const Vector* vectors, size_t count) {
+    return sum(vectors, 0, count);
+  }
+
+  /** The component-wise sum of the selected vectors. */
+  static Vector sum(const Vector* vectors, const unsigned char* mask, size_t count) {
+    const float* values = reinterpret_cast<const float*>(vectors);
+    float lanes[12] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+    size_t i = 0;
+#if defined(LEAP_MATH_SSE) || defined(LEAP_MATH_NEON)
+    Lanes a0 = splat(0), a1 = splat(0), a2 = splat(0);
+    const Lanes zero = splat(0);
+    for (; i + 4 <= count; i += 4, values += 12) {
+      if (mask) {
+        const Selection m0 = selection(mask[i], mask[i], mask[i], mask[i + 1]);
+        const Selection m1 = selection(mask[i + 1], mask[i + 1], mask[i + 2], mask[i + 2]);
+        const Selection m2 = selection(mask[i + 2], mask[i + 3], mask[i + 3], mask[i + 3]);
+        a0 = add(a0, choose(m0, load(values), zero));
+        a1 = add(a1, choose(m1, load(values + 4), zero));
+        a2 = add(a2, choose(m2, load(values + 8), zero));
+      } else {
+        a0 = add(a0, load(values));
+        a1 = add(a1, load(values + 4));
+        a2 = add(a2, load(values + 8));
+      }
+    }
+    store(lanes, a0);
+    store(lanes + 4, a1);
+    store(lanes + 8, a2);
+#endif
+    Vector result(lanes[0] + lanes[3] + lanes[6] + lanes[9],
+                  lanes[1] + lanes[4] + lanes[7] + lanes[10],
+                  lanes[2] + lanes[5] + lanes[8] + lanes[11]);
+    for (; i < count; i++, values += 3) {
+      if (!mask || mask[i]) {
+        result.x += values[0];
+        result.y += values[1];
+        result.z += values[2];
+      }
+    }
+    return result;
+  }
+
+  /**
+   * The component-wise sum of the selected vectors, for vectors stored as
+   * separate x, y and z arrays. mask may be null to sum every vector.
+   */
+  static Vector sum(const float* xs, const float* ys, const float* zs,
+                    const unsigned char* mask, size_t count) {
+    return Vector(sum(xs, mask, count), sum(ys, mask, count), sum(zs, mask, count));
+  }
+
+  /** The sum of the selected floats. mask may be null to sum all of them. */
+  static float sum(const float* values, const unsigned char* mask, size_t count) {
+    float lanes[4] = {0, 0, 0, 0};
+    size_t i = 0;
+#if defined(LEAP_MATH_SSE) || defined(LEAP_MATH_NEON)
+    Lanes total = splat(0);
+    const Lanes zero = splat(0);
+    for (; i + 4 <= count; i += 4) {
+      const Lanes v = load(values + i);
+      total = add(total, mask ? choose(selection(mask[i], mask[i + 1], mask[i + 2], mask[i + 3]), v, zero) : v);
+    }
+    store(lanes, total);
+#endif
+    float result = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    for (; i < count; i++) {
+      if (!mask || mask[i]) {
+        result += values[i];
+      }
+    }
+    return result;
+  }
+
+  /** The average of the vectors. */
+  static Vector mean(const Vector* vectors, size_t count) {
+    return count ? sum(vectors, 0, count) / (float)count : Vector();
+  }
+
+  /** The average of the selected vectors. */
+  static Vector mean(const Vector* vectors, const unsigned char* mask, size_t count) {
+    const size_t selected = mask ? countSelected(mask, count) : count;
+    return selected ? sum(vectors, mask, count) / (float)selected : Vector();
+  }
+
+  /**
+   * The weighted average of a set of points, each weight scaling its point's
+   * contribution. Returns the zero vector if the weights sum to zero.
+   */
+  static Vector centroid(const Vector* points, const float* weights, size_t count) {
+    const float* values = reinterpret_cast<const float*>(points);
+    float lanes[12] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+    float totalWeight = 0;
+    size_t i = 0;
+#if defined(LEAP_MATH_SSE) || defined(LEAP_MATH_NEON)
+    Lanes a0 = splat(0), a1 = splat(0), a2 = splat(0);
+    for (; i + 4 <= count; i += 4, values += 12) {
+      const float* w = weights + i;
+      a0 = add(a0, mul(load(values), set(w[0], w[0], w[0], w[1])));
+      a1 = add(a1, mul(load(values + 4), set(w[1], w[1], w[2], w[2])));
+      a2 = add(a2, mul(load(values + 8), set(w[2], w[3], w[3], w[3])));
+      totalWeight += w[0] + w[1] + w[2] + w[3];
+    }
+    store(lanes, a0);
+    store(lanes + 4, a1);
+    store(lanes + 8, a2);
+#endif
+    Vector result(lanes[0] + lanes[3] + lanes[6] + lanes[9],
+                  lanes[1] + lanes[4] + lanes[7] + lanes[10],
+                  lanes[2] + lanes[5] + lanes[8] + lanes[11]);
+    for (; i < count; i++, values += 3) {
+      result.x += values[0] * weights[i];
+      result.y += values[1] * weights[i];
+      result.z += values[2] * weights[i];
+      totalWeight += weights[i];
+    }
+    return totalWeight != 0 ? result / totalWeight : Vector();
+  }
+
+  /** The component-wise minimum of the vectors. */
+  static Vector min(const Vector* vectors, size_t count) {
+    return extreme(vectors, 0, count, true);
+  }
+
+  /** The component-wise minimum of the selected vectors. */
+  static Vector min(const Vector* vectors, const unsigned char* mask, size_t count) {
+    return extreme(vectors, mask, count, true);
+  }
+
+  /** The component-wise maximum of the vectors. */
+  static Vector max(const Vector* vectors, size_t count) {
+    return extreme(vectors, 0, count, false);
+  }
+
+  /** The component-wise maximum of the selected vectors. */
+  static Vector max(const Vector* vectors, const unsigned char* mask, size_t count) {
+    return extreme(vectors, mask, count, false);
+  }
+
+  /**
+   * Fills mask with 1 for each vector the predicate accepts and 0 otherwise.
+   *
+   * \code
+   * unsigned char inFront[32];
+   * size_t n = Leap::VectorBatch::select(tips, count, inFront,
+   *                                      [](const Leap::Vector& v) { return v.z < 0; });
+   * \endcode
+   *
+   * @returns The number of selected vectors.
+   */
+  template<typename Predicate>
+  static size_t select(const Vector* vectors, size_t count, unsigned char* mask, Predicate predicate) {
+    size_t selected = 0;
+    for (size_t i = 0; i < count; i++) {
+      mask[i] = predicate(vectors[i]) ? 1 : 0;
+      selected += mask[i];
+    }
+    return selected;
+  }
+
+  /** The number of non-zero entries in a mask. */
+  static size_t countSelected(const unsigned char* mask, size_t count) {
+    size_t selected = 0;
+    for (size_t i = 0; i < count; i++) {
+      selected += mask[i] != 0;
+    }
+    return selected;
+  }
+
+private:
+  static Vector extreme(const Vector* vectors, const unsigned char* mask, size_t count, bool smallest) {
+    const float* values = reinterpret_cast<const float*>(vectors);
+    const float fill = smallest ? FLT_MAX : -FLT_MAX;
+    float lanes[12];
+    for (int k = 0; k < 12; k++) {
+      lanes[k] = fill;
+    }
+    bool any = false;
+    size_t i = 0;
+#if defined(LEAP_MATH_SSE) || defined(LEAP_MATH_NEON)
+    const Lanes filler = splat(fill);
+    Lanes a0 = filler, a1 = filler, a2 = filler;
+    for (; i + 4 <= count; i += 4, values += 12) {
+      Lanes v0 = load(values), v1 = load(values + 4), v2 = load(values + 8);
+      if (mask) {
+        v0 = choose(selection(mask[i], mask[i], mask[i], mask[i + 1]), v0, filler);
+        v1 = choose(selection(mask[i + 1], mask[i + 1], mask[i + 2], mask[i + 2]), v1, filler);
+        v2 = choose(selection(mask[i + 2], mask[i + 3], mask[i + 3], mask[i + 3]), v2, filler);
+        any = any || (mask[i] | mask[i + 1] | mask[i + 2] | mask[i + 3]);
+      } else {
+        any = true;
+      }
+      a0 = smallest ? minimum(a0, v0) : maximum(a0, v0);
+      a1 = smallest ? minimum(a1, v1) : maximum(a1, v1);
+      a2 = smallest ? minimum(a2, v2) : maximum(a2, v2);
+    }
+    store(lanes, a0);
+    store(lanes + 4, a1);
+    store(lanes + 8, a2);
+#endif
+    for (; i < count; i++, values += 3) {
+      if (!mask || mask[i]) {
+        for (int k = 0; k < 3; k++) {
+          lanes[k] = smallest ? (values[k] < lanes[k] ? values[k] : lanes[k])
+                              : (values[k] > lanes[k] ? values[k] : lanes[k]);
+        }
+        any = true;
+      }
+    }
+    if (!any) {
+      return Vector();
+    }
+    float result[3];
+    for (int k = 0; k < 3; k++) {
+      result[k] = lanes[k];
+      for (int j = k + 3; j < 12; j += 3) {
+        result[k] = smallest ? (lanes[j] < result[k] ? lanes[j] : result[k])
+                             : (lanes[j] > result[k] ? lanes[j] : result[k]);
+      }
+    }
+    return Vector(result[0], result[1], result[2]);
+  }
+
+#if defined(LEAP_MATH_SSE)
+  typedef __m128 Lanes;
+  typedef __m128 Selection;
+  static Lanes load(const float* p) { return _mm_loadu_ps(p); }
+  static void store(float* p, Lanes v) { _mm_storeu_ps(p, v); }
+  static Lanes splat(float f) { return _mm_set1_ps(f); }
+  static Lanes set(float a, float b, float c, float d) { return _mm_setr_ps(a, b, c, d); }
+  static Lanes add(Lanes a, Lanes b) { return _mm_add_ps(a, b); }
+  static Lanes mul(Lanes a, Lanes b) { return _mm_mul_ps(a, b); }
+  static Lanes minimum(Lanes a, Lanes b) { return _mm_min_ps(a, b); }
+  static Lanes maximum(Lanes a, Lanes b) { return _mm_max_ps(a, b); }
+  /** All bits set in the lanes whose mask byte is non-zero. */
+  static Selection selection(unsigned char a, unsigned char b, unsigned char c, unsigned char d) {
+    return _mm_cmpneq_ps(_mm_setr_ps(a, b, c, d), _mm_setzero_ps());
+  }
+  static Lanes choose(Selection selected, Lanes a, Lanes b) {
+    return _mm_or_ps(_mm_and_ps(selected, a), _mm_andnot_ps(selected, b));
+  }
+#elif defined(LEAP_MATH_NEON)
+  typedef float32x4_t Lanes;
+  typedef uint32x4_t Selection;
+  static Lanes load(const float* p) { return vld1q_f32(p); }
+  static void store(float* p, Lanes v) { vst1q_f32(p, v); }
+  static Lanes splat(float f) { return vdupq_n_f32(f); }
+  static Lanes set(float a, float b, float c, float d) {
+    const float values[4] = {a, b, c, d};
+    return vld1q_f32(values);
+  }
+  static Lanes add(Lanes a, Lanes b) { return vaddq_f32(a, b); }
+  static Lanes mul(Lanes a, Lanes b) { return vmulq_f32(a, b); }
+  static Lanes minimum(Lanes a, Lanes b) { return vminq_f32(a, b); }
+  static Lanes maximum(Lanes a, Lanes b) { return vmaxq_f32(a, b); }
+  /** All bits set in the lanes whose mask byte is non-zero. */
+  static Selection selection(unsigned char a, unsigned char b, unsigned char c, unsigned char d) {
+    const uint32_t values[4] = {a, b, c, d};
+    return vtstq_u32(vld1q_u32(values), vld1q_u32(values));
+  }
+  static Lanes choose(Selection selected, Lanes a, Lanes b) { return vbslq_f32(selected, a, b); }
+#endif
+};
+
 }; // namespace Leap
 
 #endif // __LeapMath_h__
@@ -23,7 +23,24 @@ The screen calibration API brought Pointable objects to wrap and keep
 around a C++ Leap::Pointable object as well.
 
 Because the wrapped C++ object is kept around, attributes such as position
-and velocity now have their ObjectiveC objects created lazily.
+and velocity now have their ObjectiveC objects created lazily. The
+...Value accessors (tipPositionValue, palmVelocityValue, ...) skip the
+object altogether and return a LeapVectorValue struct.
+
+The same applies to the hand and pointable hierarchy: [frame hands],
+[frame pointables], [frame fingers] and [frame tools] are only built on
+first access, and the pointable arrays are backed by the underlying
+Leap list so a LeapPointable is only created for an index that is read.
+Linkage between LeapHand and LeapPointable objects is resolved at that
+point through [frame hand:]. The id lookups on LeapFrame ([frame hand:],
+[frame finger:], ...) go through a hash table built on the first lookup,
+and [hand finger:] and gesture hands/pointables return the frame's own
+wrappers.
+
+Code that reads every hand or pointable each frame can skip the objects
+entirely: [frame getHandValues:capacity:], [frame getPointableValues:capacity:]
+and [hand getPointableValues:capacity:] fill a caller's array of
+LeapHandValue or LeapPointableValue structs in one pass over the list.
 
 Major Leap API features supported in this wrapper today:
 * Obtaining data through both polling (LeapController only) as well as
@@ -53,12 +70,82 @@ Notes:
 
 *************************************************************************/
 
+//////////////////////////////////////////////////////////////////////////
+//VECTOR VALUE
+// A vector by value, laid out like Leap::Vector. The ...Value accessors on
+// LeapPointable and LeapHand return these so code reading many vectors per
+// frame doesn't allocate a LeapVector for each one.
+typedef struct {
+    float x;
+    float y;
+    float z;
+} LeapVectorValue;
+
+static inline LeapVectorValue LeapVectorValueMake(float x, float y, float z)
+{
+    LeapVectorValue v = { x, y, z };
+    return v;
+}
+
+static inline LeapVectorValue LeapVectorValuePlus(LeapVectorValue a, LeapVectorValue b)
+{
+    return LeapVectorValueMake(a.x + b.x, a.y + b.y, a.z + b.z);
+}
+
+static inline LeapVectorValue LeapVectorValueMinus(LeapVectorValue a, LeapVectorValue b)
+{
+    return LeapVectorValueMake(a.x - b.x, a.y - b.y, a.z - b.z);
+}
+
+static inline LeapVectorValue LeapVectorValueTimes(LeapVectorValue v, float scalar)
+{
+    return LeapVectorValueMake(v.x * scalar, v.y * scalar, v.z * scalar);
+}
+
+static inline LeapVectorValue LeapVectorValueDivide(LeapVectorValue v, float scalar)
+{
+    return LeapVectorValueMake(v.x / scalar, v.y / scalar, v.z / scalar);
+}
+
+static inline float LeapVectorValueDot(LeapVectorValue a, LeapVectorValue b)
+{
+    return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+//////////////////////////////////////////////////////////////////////////
+//HAND AND POINTABLE VALUES
+// Everything the value accessors return for one hand or pointable, filled in
+// bulk by the get...Values:capacity: methods.
+typedef struct {
+    int32_t id;
+    LeapVectorValue palmPosition;
+    LeapVectorValue palmVelocity;
+    LeapVectorValue palmNormal;
+    LeapVectorValue direction;
+    LeapVectorValue sphereCenter;
+    float sphereRadius;
+} LeapHandValue;
+
+typedef struct {
+    int32_t id;
+    int32_t handId;     // -1 when not attached to a hand
+    LeapVectorValue tipPosition;
+    LeapVectorValue tipVelocity;
+    LeapVectorValue direction;
+    float width;
+    float length;
+    BOOL isFinger;
+    BOOL isTool;
+} LeapPointableValue;
+
 //////////////////////////////////////////////////////////////////////////
 //VECTOR
 @interface LeapVector : NSObject
 
 - (id)initWithX:(float)x y:(float)y z:(float)z;
 - (id)initWithVector:(const LeapVector *)vector;
+- (id)initWithValue:(LeapVectorValue)value;
+- (LeapVectorValue)value;
 - (NSString *)description;
 - (float)pitch;
 - (float)roll;
@@ -159,6 +246,9 @@ typedef enum LeapGestureState {
 - (const LeapVector *)tipPosition;
 - (const LeapVector *)tipVelocity;
 - (const LeapVector *)direction;
+- (LeapVectorValue)tipPositionValue;
+- (LeapVectorValue)tipVelocityValue;
+- (LeapVectorValue)directionValue;
 - (float)width;
 - (float)length;
 - (BOOL)isFinger;
@@ -200,7 +290,13 @@ typedef enum LeapGestureState {
 - (const LeapVector *)palmNormal;
 - (const LeapVector *)direction;
 - (const LeapVector *)sphereCenter;
+- (LeapVectorValue)palmPositionValue;
+- (LeapVectorValue)palmVelocityValue;
+- (LeapVectorValue)palmNormalValue;
+- (LeapVectorValue)directionValue;
+- (LeapVectorValue)sphereCenterValue;
 - (float)sphereRadius;
+- (NSUInteger)getPointableValues:(LeapPointableValue *)values capacity:(NSUInteger)capacity;
 - (BOOL)isValid;
 - (const LeapFrame *)frame;
 - (LeapVector *)translation:(const LeapFrame *)since_frame;
@@ -242,8 +338,8 @@ typedef enum LeapGestureState {
 @interface LeapGesture : NSObject
 
 @property (nonatomic, strong, readonly)LeapFrame *frame;
-@property (nonatomic, weak, readonly)NSArray *hands;
-@property (nonatomic, weak, readonly)NSArray *pointables;
+@property (nonatomic, strong, readonly)NSArray *hands;
+@property (nonatomic, strong, readonly)NSArray *pointables;
 
 - (NSString *)description;
 - (LeapGestureType)type;
@@ -324,6 +420,8 @@ typedef enum LeapGestureState {
 - (const LeapPointable *)pointable:(int32_t)pointable_id;
 - (const LeapFinger *)finger:(int32_t)finger_id;
 - (const LeapTool *)tool:(int32_t)tool_id;
+- (NSUInteger)getHandValues:(LeapHandValue *)values capacity:(NSUInteger)capacity;
+- (NSUInteger)getPointableValues:(LeapPointableValue *)values capacity:(NSUInteger)capacity;
 - (NSArray *)gestures:(const LeapFrame *)since_frame;
 - (LeapGesture *)gesture:(int32_t)gesture_id;
 - (LeapVector *)translation:(const LeapFrame *)since_frame;
@@ -390,6 +488,7 @@ To run:
 - (id)initWithDelegate:(id)delegate;
 - (BOOL)addDelegate:(id)delegate;
 - (BOOL)removeDelegate:(id)delegate;
+- (void *)interfaceController;
 - (LeapFrame *)frame:(int)history;
 - (LeapConfig *)config;
 - (BOOL)isConnected;
@@ -8,9 +8,335 @@
 
 #import "LeapObjectiveC.h"
 
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <mutex>
+#include <new>
 #include <string>
 #import "Leap.h"
 
+static_assert(sizeof(LeapVectorValue) == sizeof(Leap::Vector), "LeapVectorValue must match Leap::Vector");
+
+static inline LeapVectorValue leapVectorValue(const Leap::Vector &v)
+{
+    return LeapVectorValueMake(v.x, v.y, v.z);
+}
+
+static void leapHandValue(const Leap::Hand &hand, LeapHandValue &value)
+{
+    value.id = hand.id();
+    value.palmPosition = leapVectorValue(hand.palmPosition());
+    value.palmVelocity = leapVectorValue(hand.palmVelocity());
+    value.palmNormal = leapVectorValue(hand.palmNormal());
+    value.direction = leapVectorValue(hand.direction());
+    value.sphereCenter = leapVectorValue(hand.sphereCenter());
+    value.sphereRadius = hand.sphereRadius();
+}
+
+// Fills values from any list with count() and operator[], reading each
+// element once. Returns how many were filled, at most capacity.
+template<typename L>
+static NSUInteger leapPointableValues(const L &list, LeapPointableValue *values, NSUInteger capacity)
+{
+    const NSUInteger count = MIN((NSUInteger)list.count(), capacity);
+    for (NSUInteger i = 0; i < count; i++) {
+        const Leap::Pointable pointable = list[(int)i];
+        LeapPointableValue &value = values[i];
+        value.id = pointable.id();
+        const Leap::Hand hand = pointable.hand();
+        value.handId = hand.isValid() ? hand.id() : -1;
+        value.tipPosition = leapVectorValue(pointable.tipPosition());
+        value.tipVelocity = leapVectorValue(pointable.tipVelocity());
+        value.direction = leapVectorValue(pointable.direction());
+        value.width = pointable.width();
+        value.length = pointable.length();
+        value.isFinger = pointable.isFinger();
+        value.isTool = pointable.isTool();
+    }
+    return count;
+}
+
+//////////////////////////////////////////////////////////////////////////
+//FRAME ARENA
+// Backing store for the C++ handles wrapped out of one frame: the
+// Leap::Frame itself and every hand, pointable, gesture and list view taken
+// from it. Handles are bump allocated from blocks the arena keeps and are
+// destroyed together once the frame and the last wrapper referring to them
+// are gone. The arena then goes back to a small pool for the next frame, so
+// once the pool is warm wrapping a frame doesn't malloc or free any of them.
+//
+// Like the lazily built arrays it backs, an arena isn't filled from two
+// threads at once; references can be dropped from any thread.
+class LeapFrameArena
+{
+public:
+    // An empty arena holding one reference.
+    static LeapFrameArena *acquire();
+
+    void retain() { _references.fetch_add(1, std::memory_order_relaxed); }
+    void release();
+
+    // Copy of value, destroyed when the arena is recycled.
+    template<typename T>
+    T *make(const T &value)
+    {
+        Destructor *destructor = (Destructor *)allocate(sizeof(Destructor) + sizeof(T));
+        destructor->destroy = &destroy<T>;
+        destructor->next = _destructors;
+        _destructors = destructor;
+        return new (destructor + 1) T(value);
+    }
+
+    // Zeroed storage its owner cleans up.
+    void *allocateZeroed(size_t bytes)
+    {
+        void *storage = allocate(bytes);
+        memset(storage, 0, bytes);
+        return storage;
+    }
+
+private:
+    enum { BlockSize = 4096, Alignment = 16, PoolLimit = 8, KeptBlocks = 4 };
+
+    struct alignas(Alignment) Block {
+        Block *next;
+        size_t size;
+    };
+    struct alignas(Alignment) Destructor {
+        void (*destroy)(void *);
+        Destructor *next;
+    };
+
+    template<typename T>
+    static void destroy(void *object)
+    {
+        static_cast<T *>(object)->~T();
+    }
+
+    LeapFrameArena() : _first(NULL), _current(NULL), _used(0), _destructors(NULL), _nextFree(NULL) {}
+    ~LeapFrameArena();
+    LeapFrameArena(const LeapFrameArena &);
+    LeapFrameArena &operator=(const LeapFrameArena &);
+
+    void *allocate(size_t bytes);
+    void recycle();
+
+    Block *_first;
+    Block *_current;
+    size_t _used;
+    Destructor *_destructors;
+    std::atomic<int> _references;
+    LeapFrameArena *_nextFree;
+
+    static std::mutex _poolLock;
+    static LeapFrameArena *_pool;
+    static int _pooled;
+};
+
+std::mutex LeapFrameArena::_poolLock;
+LeapFrameArena *LeapFrameArena::_pool = NULL;
+int LeapFrameArena::_pooled = 0;
+
+LeapFrameArena *LeapFrameArena::acquire()
+{
+    LeapFrameArena *arena = NULL;
+    {
+        std::lock_guard<std::mutex> lock(_poolLock);
+        if (_pool != NULL) {
+            arena = _pool;
+            _pool = arena->_nextFree;
+            _pooled--;
+        }
+    }
+    if (arena == NULL) {
+        arena = new LeapFrameArena();
+    }
+    arena->_references.store(1, std::memory_order_relaxed);
+    return arena;
+}
+
+void LeapFrameArena::release()
+{
+    if (_references.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+        return;
+    }
+    recycle();
+    {
+        std::lock_guard<std::mutex> lock(_poolLock);
+        if (_pooled < PoolLimit) {
+            _nextFree = _pool;
+            _pool = this;
+            _pooled++;
+            return;
+        }
+    }
+    delete this;
+}
+
+LeapFrameArena::~LeapFrameArena()
+{
+    Block *block = _first;
+    while (block != NULL) {
+        Block *next = block->next;
+        free(block);
+        block = next;
+    }
+}
+
+void *LeapFrameArena::allocate(size_t bytes)
+{
+    bytes = (bytes + Alignment - 1) & ~(size_t)(Alignment - 1);
+    while (_current != NULL) {
+        if (_used + bytes <= _current->size) {
+            void *storage = (char *)(_current + 1) + _used;
+            _used += bytes;
+            return storage;
+        }
+        if (_current->next == NULL) {
+            break;
+        }
+        _current = _current->next;
+        _used = 0;
+    }
+    // up to KeptBlocks blocks are kept when the arena is recycled, so this
+    // mostly happens while the pool warms up or for an unusually big frame
+    const size_t size = bytes > (size_t)BlockSize ? bytes : (size_t)BlockSize;
+    Block *block = (Block *)malloc(sizeof(Block) + size);
+    if (block == NULL) {
+        throw std::bad_alloc();
+    }
+    block->next = NULL;
+    block->size = size;
+    if (_current != NULL) {
+        _current->next = block;
+    } else {
+        _first = block;
+    }
+    _current = block;
+    _used = bytes;
+    return block + 1;
+}
+
+void LeapFrameArena::recycle()
+{
+    Destructor *destructor = _destructors;
+    while (destructor != NULL) {
+        Destructor *next = destructor->next;
+        destructor->destroy(destructor + 1);
+        destructor = next;
+    }
+    _destructors = NULL;
+    // a pooled arena keeps enough blocks for a typical frame; anything an
+    // unusually big one needed beyond that goes back to the heap
+    Block *kept = _first;
+    for (int i = 1; kept != NULL && i < KeptBlocks; i++) {
+        kept = kept->next;
+    }
+    if (kept != NULL) {
+        Block *block = kept->next;
+        kept->next = NULL;
+        while (block != NULL) {
+            Block *next = block->next;
+            free(block);
+            block = next;
+        }
+    }
+    _current = _first;
+    _used = 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+//ID TABLE
+// Open addressing map from hand, pointable or gesture id to its index in one
+// of the frame's lists, built in a single pass over the list the first time an id
+// is looked up and carved out of the frame's arena.
+class LeapIdTable
+{
+public:
+    template<typename L>
+    static LeapIdTable *build(LeapFrameArena *arena, const L &list)
+    {
+        const int count = list.count();
+        LeapIdTable *table = arena->make(LeapIdTable(arena, count));
+        for (int i = 0; i < count; i++) {
+            table->insert(list[i].id(), i);
+        }
+        return table;
+    }
+
+    // Index of id in the list, or -1.
+    int find(int32_t id) const
+    {
+        for (uint32_t slot = hash(id); ; slot = (slot + 1) & _mask) {
+            if (_slots[slot].position == 0) {
+                return -1;
+            }
+            if (_slots[slot].id == id) {
+                return _slots[slot].position - 1;
+            }
+        }
+    }
+
+private:
+    // position is the index plus one, so zeroed slots are empty
+    struct Slot {
+        int32_t id;
+        int32_t position;
+    };
+
+    LeapIdTable(LeapFrameArena *arena, int count)
+    {
+        // at most half full, so probes stay short and always end
+        uint32_t size = 4;
+        while (size < (uint32_t)count * 2) {
+            size *= 2;
+        }
+        _slots = (Slot *)arena->allocateZeroed(size * sizeof(Slot));
+        _mask = size - 1;
+    }
+
+    uint32_t hash(int32_t id) const
+    {
+        return ((uint32_t)id * 2654435761u) & _mask;
+    }
+
+    // ids are unique within a list; keep the first if one isn't
+    void insert(int32_t id, int index)
+    {
+        uint32_t slot = hash(id);
+        while (_slots[slot].position != 0) {
+            if (_slots[slot].id == id) {
+                return;
+            }
+            slot = (slot + 1) & _mask;
+        }
+        _slots[slot].id = id;
+        _slots[slot].position = index + 1;
+    }
+
+    Slot *_slots;
+    uint32_t _mask;
+};
+
+@interface LeapFrame ()
+
+- (LeapFrameArena *)arena;
+
+@end
+
+// A reference to frame's arena, or to a fresh one for wrappers made
+// without a frame.
+static LeapFrameArena *leapFrameArena(const LeapFrame *frame)
+{
+    LeapFrameArena *arena = [frame arena];
+    if (arena == NULL) {
+        return LeapFrameArena::acquire();
+    }
+    arena->retain();
+    return arena;
+}
+
 //////////////////////////////////////////////////////////////////////////
 //VECTOR
 @implementation LeapVector
@@ -42,6 +368,22 @@
     return self;
 }
 
+- (id)initWithValue:(LeapVectorValue)value
+{
+    self = [super init];
+    if (self) {
+        _x = value.x;
+        _y = value.y;
+        _z = value.z;
+    }
+    return self;
+}
+
+- (LeapVectorValue)value
+{
+    return LeapVectorValueMake(_x, _y, _z);
+}
+
 - (id)initWithLeapVector:(void *)leapVector;
 {
     self = [super init];
@@ -76,12 +418,12 @@
 
 - (LeapVector *)plus:(const LeapVector *)vector
 {
-    return [[LeapVector alloc] initWithX:(_x + [vector x]) y:(_y + [vector y]) z:(_z + [vector z])];
+    return [[LeapVector alloc] initWithValue:LeapVectorValuePlus([self value], [vector value])];
 }
 
 - (LeapVector *)minus:(const LeapVector *)vector
 {
-    return [[LeapVector alloc] initWithX:(_x - [vector x]) y:(_y - [vector y]) z:(_z - [vector z])];
+    return [[LeapVector alloc] initWithValue:LeapVectorValueMinus([self value], [vector value])];
 }
 
 - (LeapVector *)negate
@@ -101,12 +443,13 @@
 
 - (BOOL)equals:(const LeapVector *)vector
 {
-    return _x == [vector x] && _y == [vector y] && _z == [vector z];
+    const LeapVectorValue other = [vector value];
+    return _x == other.x && _y == other.y && _z == other.z;
 }
 
 - (float)dot:(LeapVector *)vector
 {
-    return _x * [vector x] + _y * [vector y] + _z * [vector z];
+    return LeapVectorValueDot([self value], [vector value]);
 }
 
 - (LeapVector *)cross:(LeapVector *)vector
@@ -285,18 +628,20 @@
 
 - (LeapVector *)transformPoint:(const LeapVector *)point
 {
-    LeapVector *a = [_xBasis times:[point x]];
-    LeapVector *b = [_yBasis times:[point y]];
-    LeapVector *c = [_zBasis times:[point z]];
-    return [[[a plus:b] plus:c] plus:_origin];
+    const LeapVectorValue p = [point value];
+    const LeapVectorValue a = LeapVectorValueTimes([_xBasis value], p.x);
+    const LeapVectorValue b = LeapVectorValueTimes([_yBasis value], p.y);
+    const LeapVectorValue c = LeapVectorValueTimes([_zBasis value], p.z);
+    return [[LeapVector alloc] initWithValue:LeapVectorValuePlus(LeapVectorValuePlus(a, b), LeapVectorValuePlus(c, [_origin value]))];
 }
 
 - (LeapVector *)transformDirection:(const LeapVector *)direction;
 {
-    LeapVector *a = [_xBasis times:[direction x]];
-    LeapVector *b = [_yBasis times:[direction y]];
-    LeapVector *c = [_zBasis times:[direction z]];
-    return [[a plus:b] plus:c];
+    const LeapVectorValue d = [direction value];
+    const LeapVectorValue a = LeapVectorValueTimes([_xBasis value], d.x);
+    const LeapVectorValue b = LeapVectorValueTimes([_yBasis value], d.y);
+    const LeapVectorValue c = LeapVectorValueTimes([_zBasis value], d.z);
+    return [[LeapVector alloc] initWithValue:LeapVectorValuePlus(LeapVectorValuePlus(a, b), c)];
 }
 
 - (LeapMatrix *)orthoNormalized;
@@ -393,6 +738,7 @@
 @implementation LeapPointable
 {
     Leap::Pointable *_interfacePointable;
+    LeapFrameArena *_arena;
 }
 
 @synthesize frame = _frame;
@@ -402,7 +748,8 @@
 {
     self = [super init];
     if (self) {
-        _interfacePointable = new Leap::Pointable(*(const Leap::Pointable *)pointable);
+        _arena = leapFrameArena(frame);
+        _interfacePointable = _arena->make(*(const Leap::Pointable *)pointable);
         _frame = frame;
         _hand = hand;
     }
@@ -444,17 +791,32 @@
 
 - (const LeapVector *)tipPosition
 {
-    return [[LeapVector alloc] initWithX:_interfacePointable->tipPosition().x y:_interfacePointable->tipPosition().y z:_interfacePointable->tipPosition().z];
+    return [[LeapVector alloc] initWithValue:[self tipPositionValue]];
+}
+
+- (LeapVectorValue)tipPositionValue
+{
+    return leapVectorValue(_interfacePointable->tipPosition());
 }
 
 - (const LeapVector *)tipVelocity
 {
-    return [[LeapVector alloc] initWithX:_interfacePointable->tipVelocity().x y:_interfacePointable->tipVelocity().y z:_interfacePointable->tipVelocity().z];
+    return [[LeapVector alloc] initWithValue:[self tipVelocityValue]];
+}
+
+- (LeapVectorValue)tipVelocityValue
+{
+    return leapVectorValue(_interfacePointable->tipVelocity());
 }
 
 - (const LeapVector *)direction
 {
-    return [[LeapVector alloc] initWithX:_interfacePointable->direction().x y:_interfacePointable->direction().y z:_interfacePointable->direction().z];
+    return [[LeapVector alloc] initWithValue:[self directionValue]];
+}
+
+- (LeapVectorValue)directionValue
+{
+    return leapVectorValue(_interfacePointable->direction());
 }
 
 - (float)width
@@ -496,7 +858,7 @@
 
 - (void)dealloc
 {
-    delete _interfacePointable;
+    _arena->release();
 }
 
 + (LeapPointable *)invalid
@@ -550,11 +912,123 @@
 
 @end
 
+//////////////////////////////////////////////////////////////////////////
+//POINTABLE ARRAY
+// Type-erased view of a Leap::PointableList, FingerList or ToolList so a
+// single NSArray subclass can back all three without copying elements out.
+class LeapPointableListSource
+{
+public:
+    virtual ~LeapPointableListSource() {}
+    virtual int count() const = 0;
+    virtual Leap::Pointable at(int index) const = 0;
+
+    Leap::Pointable operator[](int index) const { return at(index); }
+};
+
+template<typename L>
+class LeapTypedPointableListSource : public LeapPointableListSource
+{
+public:
+    LeapTypedPointableListSource(const L &list) : _list(list), _count(list.count()) {}
+    virtual int count() const { return _count; }
+    virtual Leap::Pointable at(int index) const { return _list[index]; }
+
+private:
+    L _list;
+    int _count;
+};
+
+// An NSArray backed directly by the underlying Leap list. LeapPointable
+// wrappers are only created when an index is first read, then cached so
+// repeated reads return the same object.
+@interface LeapPointableArray : NSArray
+
+- (id)initWithSource:(LeapPointableListSource *)source arena:(LeapFrameArena *)arena elementClass:(Class)elementClass frame:(const LeapFrame *)frame hand:(const LeapHand *)hand;
+
+@end
+
+@implementation LeapPointableArray
+{
+    LeapPointableListSource *_source;
+    LeapFrameArena *_arena;
+    int _count;
+    Class _elementClass;
+    __weak const LeapFrame *_frame;
+    __weak const LeapHand *_hand;
+    __strong id *_objects;
+}
+
+// source lives in arena; elementClass of nil means "pick LeapFinger/LeapTool
+// per element"
+- (id)initWithSource:(LeapPointableListSource *)source arena:(LeapFrameArena *)arena elementClass:(Class)elementClass frame:(const LeapFrame *)frame hand:(const LeapHand *)hand
+{
+    self = [super init];
+    if (self) {
+        _source = source;
+        _arena = arena;
+        _arena->retain();
+        _count = source->count();
+        _elementClass = elementClass;
+        _frame = frame;
+        _hand = hand;
+    }
+    return self;
+}
+
+- (NSUInteger)count
+{
+    return _count;
+}
+
+- (id)objectAtIndex:(NSUInteger)index
+{
+    if (index >= (NSUInteger)_count) {
+        [NSException raise:NSRangeException format:@"index %lu beyond bounds [0 .. %d]", (unsigned long)index, _count - 1];
+    }
+    if (_objects == NULL) {
+        _objects = (__strong id *)_arena->allocateZeroed(_count * sizeof(id));
+    }
+    if (_objects[index] == nil) {
+        const Leap::Pointable leapPointable = _source->at((int)index);
+        const LeapHand *hand = _hand;
+        if (hand == nil) {
+            const Leap::Hand leapHand = leapPointable.hand();
+            hand = leapHand.isValid() ? [_frame hand:leapHand.id()] : [LeapHand invalid];
+        }
+        LeapPointable *pointable = (_elementClass == nil ?
+                                    [LeapPointable typedPointableAlloc:(void *)&leapPointable] :
+                                    [_elementClass alloc]);
+        _objects[index] = [pointable initWithPointable:(void *)&leapPointable frame:_frame hand:hand];
+    }
+    return _objects[index];
+}
+
+- (void)dealloc
+{
+    // the arena doesn't know these are strong references
+    if (_objects != NULL) {
+        for (int i = 0; i < _count; i++) {
+            _objects[i] = nil;
+        }
+    }
+    _arena->release();
+}
+
+@end
+
 //////////////////////////////////////////////////////////////////////////
 //HAND
 @implementation LeapHand
 {
     Leap::Hand *_interfaceHand;
+    LeapFrameArena *_arena;
+    // built once, like the frame's arrays: the arena only gives memory back
+    // when the whole frame goes, so a new array per call would keep growing
+    // it for as long as someone polls this hand
+    NSArray *_pointables;
+    NSArray *_fingers;
+    NSArray *_tools;
 }
 
 @synthesize frame = _frame;
@@ -563,7 +1037,8 @@
 {
     self = [super init];
     if (self) {
-        _interfaceHand = new Leap::Hand(*(const Leap::Hand *)hand);
+        _arena = leapFrameArena(frame);
+        _interfaceHand = _arena->make(*(const Leap::Hand *)hand);
         _frame = frame;
     }
     return self;
@@ -584,78 +1059,107 @@
 
 - (NSArray *)pointables
 {
-    NSMutableArray *pointables_ar = [NSMutableArray array];
-    for (int i = 0; i < _interfaceHand->pointables().count(); i++) {
-        const Leap::Pointable &tmpLeapPointable = _interfaceHand->pointables()[i];
-        LeapPointable *pointable = [[LeapPointable typedPointableAlloc:(void *)&tmpLeapPointable] initWithPointable:(void *)&tmpLeapPointable frame:_frame hand:self];
-        [pointables_ar addObject:pointable];
+    if (_pointables == nil) {
+        LeapPointableListSource *source = _arena->make(LeapTypedPointableListSource<Leap::PointableList>(_interfaceHand->pointables()));
+        _pointables = [[LeapPointableArray alloc] initWithSource:source arena:_arena elementClass:nil frame:_frame hand:self];
     }
-    return [NSArray arrayWithArray:pointables_ar];
+    return _pointables;
 }
 
 - (NSArray *)fingers
 {
-    NSMutableArray *fingers_ar = [NSMutableArray array];
-    for (int i = 0; i < _interfaceHand->fingers().count(); i++) {
-        const Leap::Finger &tmpLeapFinger = _interfaceHand->fingers()[i];
-        LeapFinger *finger = [[LeapFinger alloc] initWithPointable:(void *)&tmpLeapFinger frame:_frame hand:self];
-        [fingers_ar addObject:finger];
+    if (_fingers == nil) {
+        LeapPointableListSource *source = _arena->make(LeapTypedPointableListSource<Leap::FingerList>(_interfaceHand->fingers()));
+        _fingers = [[LeapPointableArray alloc] initWithSource:source arena:_arena elementClass:[LeapFinger class] frame:_frame hand:self];
     }
-    return [NSArray arrayWithArray:fingers_ar];
+    return _fingers;
 }
 
 - (NSArray *)tools
 {
-    NSMutableArray *tools_ar = [NSMutableArray array];
-    for (int i = 0; i < _interfaceHand->tools().count(); i++) {
-        const Leap::Tool &tmpLeapTool = _interfaceHand->tools()[i];
-        LeapTool *tool = [[LeapTool alloc] initWithPointable:(void *)&tmpLeapTool frame:_frame hand:self];
-        [tools_ar addObject:tool];
+    if (_tools == nil) {
+        LeapPointableListSource *source = _arena->make(LeapTypedPointableListSource<Leap::ToolList>(_interfaceHand->tools()));
+        _tools = [[LeapPointableArray alloc] initWithSource:source arena:_arena elementClass:[LeapTool class] frame:_frame hand:self];
     }
-    return [NSArray arrayWithArray:tools_ar];
+    return _tools;
+}
+
+// Whether pointable, found through the frame's id tables, belongs to this
+// hand; if so it's returned in place of a new wrapper. The frame has every
+// pointable, so one it doesn't have, or one of another hand's, is invalid
+// for this hand too.
+- (BOOL)holds:(const LeapPointable *)pointable
+{
+    return pointable != nil && [pointable isValid] &&
+        ((const Leap::Pointable *)[pointable interfacePointable])->hand().id() == _interfaceHand->id();
 }
 
 - (const LeapPointable *)pointable:(int32_t)pointable_id
 {
-    const Leap::Pointable &tmpLeapPointable = _interfaceHand->pointable(pointable_id);
-    return [[LeapPointable typedPointableAlloc:(void *)&tmpLeapPointable] initWithPointable:(void *)&tmpLeapPointable frame:_frame hand:self];
+    const LeapPointable *pointable = [_frame pointable:pointable_id];
+    return [self holds:pointable] ? pointable : [LeapPointable invalid];
 }
 
 - (const LeapFinger *)finger:(int32_t)finger_id
 {
-    const Leap::Finger &tmpLeapFinger = _interfaceHand->finger(finger_id);
-    return [[LeapFinger alloc] initWithPointable:(void *)&tmpLeapFinger frame:_frame hand:self];
+    const LeapPointable *finger = [_frame finger:finger_id];
+    return (const LeapFinger *)([self holds:finger] ? finger : [LeapFinger invalid]);
 }
 
 - (const LeapTool *)tool:(int32_t)tool_id
 {
-    const Leap::Tool &tmpLeapTool = _interfaceHand->tool(tool_id);
-    return [[LeapTool alloc] initWithPointable:(void *)&tmpLeapTool frame:_frame hand:self];
+    const LeapPointable *tool = [_frame tool:tool_id];
+    return (const LeapTool *)([self holds:tool] ? tool : [LeapTool invalid]);
 }
 
 - (const LeapVector *)palmPosition
 {
-    return [[LeapVector alloc] initWithX:_interfaceHand->palmPosition().x y:_interfaceHand->palmPosition().y z:_interfaceHand->palmPosition().z];
+    return [[LeapVector alloc] initWithValue:[self palmPositionValue]];
+}
+
+- (LeapVectorValue)palmPositionValue
+{
+    return leapVectorValue(_interfaceHand->palmPosition());
 }
 
 - (const LeapVector *)palmVelocity
 {
-    return [[LeapVector alloc] initWithX:_interfaceHand->palmVelocity().x y:_interfaceHand->palmVelocity().y z:_interfaceHand->palmVelocity().z];
+    return [[LeapVector alloc] initWithValue:[self palmVelocityValue]];
+}
+
+- (LeapVectorValue)palmVelocityValue
+{
+    return leapVectorValue(_interfaceHand->palmVelocity());
 }
 
 - (const LeapVector *)palmNormal
 {
-    return [[LeapVector alloc] initWithX:_interfaceHand->palmNormal().x y:_interfaceHand->palmNormal().y z:_interfaceHand->palmNormal().z];
+    return [[LeapVector alloc] initWithValue:[self palmNormalValue]];
+}
+
+- (LeapVectorValue)palmNormalValue
+{
+    return leapVectorValue(_interfaceHand->palmNormal());
 }
 
 - (const LeapVector *)direction
 {
-    return [[LeapVector alloc] initWithX:_interfaceHand->direction().x y:_interfaceHand->direction().y z:_interfaceHand->direction().z];
+    return [[LeapVector alloc] initWithValue:[self directionValue]];
+}
+
+- (LeapVectorValue)directionValue
+{
+    return leapVectorValue(_interfaceHand->direction());
 }
 
 - (const LeapVector *)sphereCenter
 {
-    return [[LeapVector alloc] initWithX:_interfaceHand->sphereCenter().x y:_interfaceHand->sphereCenter().y z:_interfaceHand->sphereCenter().z];
+    return [[LeapVector alloc] initWithValue:[self sphereCenterValue]];
+}
+
+- (LeapVectorValue)sphereCenterValue
+{
+    return leapVectorValue(_interfaceHand->sphereCenter());
 }
 
 - (float)sphereRadius
@@ -663,6 +1167,11 @@
     return _interfaceHand->sphereRadius();
 }
 
+- (NSUInteger)getPointableValues:(LeapPointableValue *)values capacity:(NSUInteger)capacity
+{
+    return leapPointableValues(_interfaceHand->pointables(), values, capacity);
+}
+
 - (BOOL)isValid
 {
     return _interfaceHand->isValid();
@@ -676,7 +1185,7 @@
 
 - (void)dealloc
 {
-    delete _interfaceHand;
+    _arena->release();
 }
 
 - (LeapVector *)translation:(const LeapFrame *)since_frame
@@ -829,6 +1338,7 @@
 @implementation LeapGesture
 {
     Leap::Gesture *_interfaceGesture;
+    LeapFrameArena *_arena;
 }
 
 @synthesize frame = _frame;
@@ -839,52 +1349,57 @@
 {
     self = [super init];
     if (self) {
-        NSMutableDictionary *dictionary = [[NSMutableDictionary alloc] init];
-        Leap::Frame leapFrame = *(Leap::Frame *)[frame interfaceFrame];
+        _arena = leapFrameArena(frame);
         switch(((const Leap::Gesture *)leapGesture)->type()) {
             case LEAP_GESTURE_TYPE_SWIPE:
-                _interfaceGesture = new Leap::SwipeGesture(*(const Leap::SwipeGesture *)leapGesture);
+                _interfaceGesture = _arena->make(*(const Leap::SwipeGesture *)leapGesture);
                 break;
             case LEAP_GESTURE_TYPE_CIRCLE:
-                _interfaceGesture = new Leap::CircleGesture(*(const Leap::CircleGesture *)leapGesture);
+                _interfaceGesture = _arena->make(*(const Leap::CircleGesture *)leapGesture);
                 break;
             case LEAP_GESTURE_TYPE_SCREEN_TAP:
-                _interfaceGesture = new Leap::ScreenTapGesture(*(const Leap::ScreenTapGesture *)leapGesture);
+                _interfaceGesture = _arena->make(*(const Leap::ScreenTapGesture *)leapGesture);
                 break;
             case LEAP_GESTURE_TYPE_KEY_TAP:
-                _interfaceGesture = new Leap::KeyTapGesture(*(const Leap::KeyTapGesture *)leapGesture);
+                _interfaceGesture = _arena->make(*(const Leap::KeyTapGesture *)leapGesture);
                 break;
             default:
-                _interfaceGesture = new Leap::Gesture(*(const Leap::Gesture *)leapGesture);
+                _interfaceGesture = _arena->make(*(const Leap::Gesture *)leapGesture);
         }
         _frame = frame;
-        
-        NSMutableArray *hands_ar = [NSMutableArray array];
-        for (int i = 0; i < leapFrame.hands().count(); i++) {
-            const Leap::Hand &tmpLeapHand = leapFrame.hands()[i];
-            LeapHand *hand = [[LeapHand alloc] initWithHand:(void *)&(tmpLeapHand) frame:frame];
-            [hands_ar addObject:hand];
-            [dictionary setObject:hand forKey:[NSNumber numberWithUnsignedInteger:tmpLeapHand.id()]];
+        // hands and pointables are looked up in the frame on first access
+    }
+    return self;
+}
+
+// The frame's own wrappers for the hands and pointables this gesture
+// involves, rather than copies of every hand and pointable in the frame.
+- (NSArray *)hands
+{
+    if (_hands == nil) {
+        const Leap::HandList leapHands = _interfaceGesture->hands();
+        const int count = _frame != nil ? leapHands.count() : 0;
+        NSMutableArray *hands_ar = [NSMutableArray arrayWithCapacity:count];
+        for (int i = 0; i < count; i++) {
+            [hands_ar addObject:(LeapHand *)[_frame hand:leapHands[i].id()]];
         }
         _hands = [NSArray arrayWithArray:hands_ar];
-        
-        NSMutableArray *pointables_ar = [NSMutableArray array];
-        for (int i = 0; i < leapFrame.pointables().count(); i++) {
-            const Leap::Pointable &tmpLeapPointable = leapFrame.pointables()[i];
-            const LeapHand *hand;
-            if (tmpLeapPointable.hand().isValid()) {
-                hand = [dictionary objectForKey:[NSNumber numberWithUnsignedInteger:tmpLeapPointable.hand().id()]];
-            }
-            else {
-                hand = [LeapHand invalid];
-            }
-            LeapPointable *pointable = [[LeapPointable typedPointableAlloc:(void *)&tmpLeapPointable] initWithPointable:(void *)&tmpLeapPointable frame:frame hand:hand];
-            [pointables_ar addObject:pointable];
+    }
+    return _hands;
+}
+
+- (NSArray *)pointables
+{
+    if (_pointables == nil) {
+        const Leap::PointableList leapPointables = _interfaceGesture->pointables();
+        const int count = _frame != nil ? leapPointables.count() : 0;
+        NSMutableArray *pointables_ar = [NSMutableArray arrayWithCapacity:count];
+        for (int i = 0; i < count; i++) {
+            [pointables_ar addObject:(LeapPointable *)[_frame pointable:leapPointables[i].id()]];
         }
         _pointables = [NSArray arrayWithArray:pointables_ar];
-
     }
-    return self;
+    return _pointables;
 }
 
 - (NSString *)description
@@ -935,7 +1450,7 @@
 
 - (void)dealloc
 {
-    delete _interfaceGesture;
+    _arena->release();
 }
 
 + (const LeapGesture *)invalid
@@ -1079,6 +1594,24 @@
 @implementation LeapFrame
 {
     Leap::Frame *_interfaceFrame;
+    LeapFrameArena *_arena;
+    // each list is taken from the frame once and shared by its array, its
+    // id table and the value getters
+    Leap::HandList *_leapHands;
+    LeapPointableListSource *_pointableSource;
+    LeapPointableListSource *_fingerSource;
+    LeapPointableListSource *_toolSource;
+    LeapIdTable *_handIds;
+    LeapIdTable *_pointableIds;
+    LeapIdTable *_fingerIds;
+    LeapIdTable *_toolIds;
+    Leap::GestureList *_leapGestures;
+    LeapIdTable *_gestureIds;
+    // the frame's own gestures, and the last since_frame list with the id
+    // of the frame it was since, so polling doesn't grow the arena
+    NSArray *_gestures;
+    NSArray *_gesturesSince;
+    int64_t _gesturesSinceId;
 }
 
 @synthesize hands = _hands;
@@ -1090,65 +1623,91 @@
 {
     self = [super init];
     if (self) {
-        _interfaceFrame = new Leap::Frame(*(const Leap::Frame *)frame);
-        NSMutableDictionary *dictionary = [[NSMutableDictionary alloc] init];
-        Leap::Frame leapFrame = *(Leap::Frame *)frame;
-
-        NSMutableArray *hands_ar = [NSMutableArray array];
-        for (int i = 0; i < leapFrame.hands().count(); i++) {
-            const Leap::Hand &tmpLeapHand = leapFrame.hands()[i];
-            LeapHand *hand = [[LeapHand alloc] initWithHand:(void *)&(tmpLeapHand) frame:self];
+        // hands, pointables, fingers and tools are built on first access
+        _arena = LeapFrameArena::acquire();
+        _interfaceFrame = _arena->make(*(const Leap::Frame *)frame);
+    }
+    return self;
+}
+
+- (const Leap::HandList &)leapHands
+{
+    if (_leapHands == NULL) {
+        _leapHands = _arena->make(_interfaceFrame->hands());
+    }
+    return *_leapHands;
+}
+
+- (const Leap::GestureList &)leapGestures
+{
+    if (_leapGestures == NULL) {
+        _leapGestures = _arena->make(_interfaceFrame->gestures());
+    }
+    return *_leapGestures;
+}
+
+- (LeapPointableListSource *)pointableSource
+{
+    if (_pointableSource == NULL) {
+        _pointableSource = _arena->make(LeapTypedPointableListSource<Leap::PointableList>(_interfaceFrame->pointables()));
+    }
+    return _pointableSource;
+}
+
+- (LeapPointableListSource *)fingerSource
+{
+    if (_fingerSource == NULL) {
+        _fingerSource = _arena->make(LeapTypedPointableListSource<Leap::FingerList>(_interfaceFrame->fingers()));
+    }
+    return _fingerSource;
+}
+
+- (LeapPointableListSource *)toolSource
+{
+    if (_toolSource == NULL) {
+        _toolSource = _arena->make(LeapTypedPointableListSource<Leap::ToolList>(_interfaceFrame->tools()));
+    }
+    return _toolSource;
+}
+
+- (NSArray *)hands
+{
+    if (_hands == nil) {
+        const Leap::HandList &leapHands = [self leapHands];
+        const int count = leapHands.count();
+        NSMutableArray *hands_ar = [NSMutableArray arrayWithCapacity:count];
+        for (int i = 0; i < count; i++) {
+            const Leap::Hand tmpLeapHand = leapHands[i];
+            LeapHand *hand = [[LeapHand alloc] initWithHand:(void *)&tmpLeapHand frame:self];
             [hands_ar addObject:hand];
-            [dictionary setObject:hand forKey:[NSNumber numberWithUnsignedInteger:tmpLeapHand.id()]];
         }
         _hands = [NSArray arrayWithArray:hands_ar];
+    }
+    return _hands;
+}
 
-        NSMutableArray *pointables_ar = [NSMutableArray array];
-        for (int i = 0; i < leapFrame.pointables().count(); i++) {
-            const Leap::Pointable &tmpLeapPointable = leapFrame.pointables()[i];
-            const LeapHand *hand;
-            if (tmpLeapPointable.hand().isValid()) {
-                hand = [dictionary objectForKey:[NSNumber numberWithUnsignedInteger:tmpLeapPointable.hand().id()]];
-            }
-            else {
-                hand = [LeapHand invalid];
-            }
-            LeapPointable *pointable = [[LeapPointable typedPointableAlloc:(void *)&tmpLeapPointable] initWithPointable:(void *)&tmpLeapPointable frame:self hand:hand];
-            [pointables_ar addObject:pointable];
-        }
-        _pointables = [NSArray arrayWithArray:pointables_ar];
+- (NSArray *)pointables
+{
+    if (_pointables == nil) {
+        _pointables = [[LeapPointableArray alloc] initWithSource:[self pointableSource] arena:_arena elementClass:nil frame:self hand:nil];
+    }
+    return _pointables;
+}
 
-        NSMutableArray *fingers_ar = [NSMutableArray array];
-        for (int i = 0; i < leapFrame.fingers().count(); i++) {
-            const Leap::Finger &tmpLeapFinger = leapFrame.fingers()[i];
-            const LeapHand *hand;
-            if (tmpLeapFinger.hand().isValid()) {
-                hand = [dictionary objectForKey:[NSNumber numberWithUnsignedInteger:tmpLeapFinger.hand().id()]];
-            }
-            else {
-                hand = [LeapHand invalid];
-            }
-            LeapFinger *finger = [[LeapFinger alloc] initWithPointable:(void *)&tmpLeapFinger frame:self hand:hand];
-            [fingers_ar addObject:finger];
-        }
-        _fingers = [NSArray arrayWithArray:fingers_ar];
-
-        NSMutableArray *tools_ar = [NSMutableArray array];
-        for (int i = 0; i < leapFrame.tools().count(); i++) {
-            const Leap::Tool &tmpLeapTool = leapFrame.tools()[i];
-            const LeapHand *hand;
-            if (tmpLeapTool.hand().isValid()) {
-                hand = [dictionary objectForKey:[NSNumber numberWithUnsignedInteger:tmpLeapTool.hand().id()]];
-            }
-            else {
-                hand = [LeapHand invalid];
-            }
-            LeapTool *tool = [[LeapTool alloc] initWithPointable:(void *)&tmpLeapTool frame:self hand:hand];
-            [tools_ar addObject:tool];
-        }
-        _tools = [NSArray arrayWithArray:tools_ar];
+- (NSArray *)fingers
+{
+    if (_fingers == nil) {
+        _fingers = [[LeapPointableArray alloc] initWithSource:[self fingerSource] arena:_arena elementClass:[LeapFinger class] frame:self hand:nil];
     }
-    return self;
+    return _fingers;
+}
+
+- (NSArray *)tools
+{
+    if (_tools == nil) {
+        _tools = [[LeapPointableArray alloc] initWithSource:[self toolSource] arena:_arena elementClass:[LeapTool class] frame:self hand:nil];
+    }
+    return _tools;
 }
 
 - (NSString *)description
@@ -1161,6 +1720,11 @@
     return (void *)_interfaceFrame;
 }
 
+- (LeapFrameArena *)arena
+{
+    return _arena;
+}
+
 - (int64_t)id
 {
     return _interfaceFrame->id();
@@ -1171,57 +1735,62 @@
     return _interfaceFrame->timestamp();
 }
 
+// Each table indexes the same list its array was built from, so an index
+// found here is the wrapper's index in that array.
 - (const LeapHand *)hand:(int32_t)hand_id
 {
-    NSEnumerator *e = [_hands objectEnumerator];
-    LeapHand *obj;
-    while (obj = [e nextObject]) {
-        if ([obj id] == hand_id) {
-            return obj;
-        }
+    if (_handIds == NULL) {
+        _handIds = LeapIdTable::build(_arena, [self leapHands]);
     }
-    return [LeapHand invalid];
+    const int index = _handIds->find(hand_id);
+    return index >= 0 ? [[self hands] objectAtIndex:index] : [LeapHand invalid];
 }
 
 - (const LeapPointable *)pointable:(int32_t)pointable_id
 {
-    NSEnumerator *e = [_pointables objectEnumerator];
-    LeapPointable *obj;
-    while (obj = [e nextObject]) {
-        if ([obj id] == pointable_id) {
-            return obj;
-        }
+    if (_pointableIds == NULL) {
+        _pointableIds = LeapIdTable::build(_arena, *[self pointableSource]);
     }
-    return [LeapPointable invalid];
+    const int index = _pointableIds->find(pointable_id);
+    return index >= 0 ? [[self pointables] objectAtIndex:index] : [LeapPointable invalid];
 }
 
 - (const LeapPointable *)finger:(int32_t)finger_id
 {
-    NSEnumerator *e = [_fingers objectEnumerator];
-    LeapFinger *obj;
-    while (obj = [e nextObject]) {
-        if ([obj id] == finger_id) {
-            return obj;
-        }
+    if (_fingerIds == NULL) {
+        _fingerIds = LeapIdTable::build(_arena, *[self fingerSource]);
     }
-    return [LeapFinger invalid];
+    const int index = _fingerIds->find(finger_id);
+    return index >= 0 ? [[self fingers] objectAtIndex:index] : [LeapFinger invalid];
 }
 
 - (const LeapPointable *)tool:(int32_t)tool_id
 {
-    NSEnumerator *e = [_tools objectEnumerator];
-    LeapTool *obj;
-    while (obj = [e nextObject]) {
-        if ([obj id] == tool_id) {
-            return obj;
-        }
+    if (_toolIds == NULL) {
+        _toolIds = LeapIdTable::build(_arena, *[self toolSource]);
+    }
+    const int index = _toolIds->find(tool_id);
+    return index >= 0 ? [[self tools] objectAtIndex:index] : [LeapTool invalid];
+}
+
+- (NSUInteger)getHandValues:(LeapHandValue *)values capacity:(NSUInteger)capacity
+{
+    const Leap::HandList &leapHands = [self leapHands];
+    const NSUInteger count = MIN((NSUInteger)leapHands.count(), capacity);
+    for (NSUInteger i = 0; i < count; i++) {
+        leapHandValue(leapHands[(int)i], values[i]);
     }
-    return [LeapTool invalid];
+    return count;
+}
+
+- (NSUInteger)getPointableValues:(LeapPointableValue *)values capacity:(NSUInteger)capacity
+{
+    return leapPointableValues(*[self pointableSource], values, capacity);
 }
 
 - (void)dealloc
 {
-    delete _interfaceFrame;
+    _arena->release();
 }
 
 - (LeapGesture *)typedGestureCreate:(void *)leapGesture
@@ -1248,9 +1817,22 @@
 
 - (NSArray *)gestures:(const LeapFrame *)since_frame
 {
-    Leap::GestureList leapGestures = (since_frame == nil ?
-                                      _interfaceFrame->gestures() :
-                                      _interfaceFrame->gestures(*(Leap::Frame*)[since_frame interfaceFrame]));
+    if (since_frame == nil) {
+        if (_gestures == nil) {
+            _gestures = [self gestureArray:[self leapGestures]];
+        }
+        return _gestures;
+    }
+    const int64_t sinceId = [since_frame id];
+    if (_gesturesSince == nil || _gesturesSinceId != sinceId) {
+        _gesturesSince = [self gestureArray:_interfaceFrame->gestures(*(Leap::Frame*)[since_frame interfaceFrame])];
+        _gesturesSinceId = sinceId;
+    }
+    return _gesturesSince;
+}
+
+- (NSArray *)gestureArray:(const Leap::GestureList &)leapGestures
+{
     NSMutableArray *gestures_ar = [NSMutableArray array];
     for (Leap::GestureList::const_iterator it = leapGestures.begin(); it != leapGestures.end(); ++it) {
         const Leap::Gesture leapGesture = *it;
@@ -1260,10 +1842,15 @@
     return [NSArray arrayWithArray:gestures_ar];
 }
 
+// Only the frame's own gestures have ids it knows, so the answer is always
+// one of them, found like hand: in the list gestures:nil wraps, or invalid.
 - (LeapGesture *)gesture:(int32_t) gesture_id
 {
-    Leap::Gesture leapGesture = _interfaceFrame->gesture(gesture_id);
-    return [self typedGestureCreate:(void *)&leapGesture];
+    if (_gestureIds == NULL) {
+        _gestureIds = LeapIdTable::build(_arena, [self leapGestures]);
+    }
+    const int index = _gestureIds->find(gesture_id);
+    return index >= 0 ? [[self gestures:nil] objectAtIndex:index] : (LeapGesture *)[LeapGesture invalid];
 }
 
 - (LeapVector *)translation:(const LeapFrame *)since_frame
@@ -1357,74 +1944,65 @@
 
 - (LeapValueType)type:(NSString *)key;
 {
-    std::string *keyString = new std::string([key UTF8String]);
-    Leap::Config::ValueType val = _config.type(*keyString);
-    free(keyString);
+    const std::string keyString([key UTF8String]);
+    Leap::Config::ValueType val = _config.type(keyString);
     return [self convertFromLeapValueType:val];
 }
 
 - (BOOL)getBool:(NSString *)key
 {
-    std::string *keyString = new std::string([key UTF8String]);
-    BOOL val = _config.getBool(*keyString);
-    free(keyString);
+    const std::string keyString([key UTF8String]);
+    BOOL val = _config.getBool(keyString);
     return val;
 }
 
 - (int32_t)getInt32:(NSString *)key
 {
-    std::string *keyString = new std::string([key UTF8String]);
-    int32_t val = _config.getInt32(*keyString);
-    free(keyString);
+    const std::string keyString([key UTF8String]);
+    int32_t val = _config.getInt32(keyString);
     return val;
 }
 
 - (int64_t)getInt64:(NSString *)key
 {
-    std::string *keyString = new std::string([key UTF8String]);
-    int64_t val = _config.getInt64(*keyString);
-    free(keyString);
+    const std::string keyString([key UTF8String]);
+    int64_t val = _config.getInt64(keyString);
     return val;
 }
 
 - (uint32_t)getUInt32:(NSString *)key
 {
-    std::string *keyString = new std::string([key UTF8String]);
-    uint32_t val = _config.getUInt32(*keyString);
-    free(keyString);
+    const std::string keyString([key UTF8String]);
+    uint32_t val = _config.getUInt32(keyString);
     return val;
 }
 
 - (uint64_t)getUInt64:(NSString *)key
 {
-    std::string *keyString = new std::string([key UTF8String]);
-    uint64_t val = _config.getUInt64(*keyString);
-    free(keyString);
+    const std::string keyString([key UTF8String]);
+    uint64_t val = _config.getUInt64(keyString);
     return val;
 }
 
 - (float)getFloat:(NSString *)key
 {
-    std::string *keyString = new std::string([key UTF8String]);
-    float val = _config.getFloat(*keyString);
-    free(keyString);
+    const std::string keyString([key UTF8String]);
+    float val = _config.getFloat(keyString);
     return val;
 }
 
 - (float)getDouble:(NSString *)key
 {
-    std::string *keyString = new std::string([key UTF8String]);
-    float val = _config.getDouble(*keyString);
-    free(keyString);
+    const std::string keyString([key UTF8String]);
+    float val = _config.getDouble(keyString);
     return val;
 }
 
 - (NSString *)getString:(NSString *)key
 {
-    std::string *keyString = new std::string([key UTF8String]);
-    std::string str = _config.getString(*keyString);
+    const std::string keyString([key UTF8String]);
+    std::string str = _config.getString(keyString);
     NSString *val = [[NSString alloc] initWithUTF8String:str.c_str()];
-    free(keyString);
     return val;
 }
 
@@ -1465,6 +2043,10 @@ public:
 
     virtual void onFrame(const Leap::Controller& leapController)
     {
+        // skip the per-frame NSNotification when nobody observes it
+        if (!_postsFrames.load(std::memory_order_relaxed)) {
+            return;
+        }
         @autoreleasepool {
             [[NSNotificationCenter defaultCenter] postNotificationOnMainThreadName:@"OnFrame" object:_controller];
         }
@@ -1475,8 +2057,16 @@ public:
         _controller = controller;
     }
 
+    void setPostsFrames(bool postsFrames)
+    {
+        _postsFrames.store(postsFrames, std::memory_order_relaxed);
+    }
+
+    LeapNotificationListener() : _controller(nil), _postsFrames(false) {}
+
 private:
     LeapController *_controller;
+    std::atomic<bool> _postsFrames;
 };
 
 //////////////////////////////////////////////////////////////////////////
@@ -1550,6 +2140,9 @@ private:
 {
     Leap::Controller *_controller;
     Leap::Listener *_listener;
+    LeapNotificationListener *_notificationListener;
+    // listeners observing OnFrame; frames are only posted while there's one
+    NSHashTable *_frameObservers;
 }
 
 // initWithController is used only by the wrapper
@@ -1583,6 +2176,7 @@ private:
         LeapNotificationListener *notificationListener = new LeapNotificationListener();
         notificationListener->setController(self);
         _listener = notificationListener;
+        _notificationListener = notificationListener;
         _controller = new Leap::Controller(*_listener);
     }
     return self;
@@ -1603,7 +2197,8 @@ private:
     if ([listener respondsToSelector:@selector(onExit:)]) {
         [nc addObserver:listener selector:@selector(onExit:) name:@"OnExit" object:self];
     }
-    if ([listener respondsToSelector:@selector(onInit:)]) {
+    BOOL observesFrames = [listener respondsToSelector:@selector(onFrame:)];
+    if (observesFrames) {
         [nc addObserver:listener selector:@selector(onFrame:) name:@"OnFrame" object:self];
     }
 
@@ -1611,19 +2206,38 @@ private:
         LeapNotificationListener *notificationListener = new LeapNotificationListener();
         notificationListener->setController(self);
         _listener = notificationListener;
+        _notificationListener = notificationListener;
         _controller->addListener(*notificationListener);
         // note: Because we use a single C++ Leap::Listener per controller under the hood, if you
         // have more than one LeapListener, only the first will receive @"OnInit"
     }
+    if (observesFrames) {
+        if (_frameObservers == nil) {
+            _frameObservers = [NSHashTable weakObjectsHashTable];
+        }
+        [_frameObservers addObject:listener];
+        [self updatePostsFrames];
+    }
     return TRUE;
 }
 
 - (BOOL)removeListener:(id<LeapListener>)listener
 {
     [[NSNotificationCenter defaultCenter] removeObserver:listener];
+    [_frameObservers removeObject:listener];
+    [self updatePostsFrames];
     return TRUE;
 }
 
+// allObjects rather than count, which can include listeners that have
+// since been deallocated
+- (void)updatePostsFrames
+{
+    if (_notificationListener) {
+        _notificationListener->setPostsFrames([[_frameObservers allObjects] count] > 0);
+    }
+}
+
 - (id)initWithDelegate:(id<LeapDelegate>)leapDelegate
 {
     NSAssert(!_controller, @"Attempting to initialize a controller more than once");
@@ -1657,6 +2271,11 @@ private:
     return TRUE;
 }
 
+- (void *)interfaceController
+{
+    return (void *)_controller;
+}
+
 - (LeapFrame *)frame:(int)history
 {
     Leap::Frame leapFrame = _controller->frame(history);
@@ -8,6 +8,8 @@
 
 #import "LEAPTest3Tests.h"
 
+// The gesture core's behaviour tests are plain C++ and live in Tests/ (see
+// the README); this target only hosts Objective-C tests.
 @implementation LEAPTest3Tests
 
 - (void)setUp
@@ -24,9 +26,4 @@
     [super tearDown];
 }
 
-- (void)testExample
-{
-    STFail(@"Unit tests are not implemented yet in LEAPTest3Tests");
-}
-
 @end
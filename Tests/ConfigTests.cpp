@@ -0,0 +1,102 @@
+//
+//  ConfigTests.cpp
+//  OSXGestureControl
+//
+//  Copyright (c) 2013 Chris Willingham. All rights reserved.
+//
+
+#include "TestSupport.h"
+
+#include <string.h>
+#include "../GestureController/Core/GestureConfig.h"
+#include "../GestureController/Core/TemplateRecognizer.h"
+
+using namespace GestureCore;
+
+//////////////////////////////////////////////////////////////////////////
+//CONFIG
+TEST(config, parse)
+{
+    GestureConfig config;
+    int line = -1;
+    CHECK(config.parse("# thresholds\n"
+                       "\n"
+                       "swipe.verticalThreshold = 650\n"
+                       "  swipe.refractoryUpMicros=250000   # a comment\n"
+                       "filter.kind = kalman\n"
+                       "scroll.fingers = 3", &line));
+    CHECK(config.swipe.verticalThreshold == 650);
+    CHECK(config.swipe.refractoryMicros[Up] == 250000);
+    CHECK(config.filter.kind == FilterKalman);
+    CHECK(config.scrollFingers == 3);
+    CHECK(config.value(ConfigScrollFingers) == 3);
+    CHECK(GestureConfig::keyNamed("hold.micros", strlen("hold.micros")) == ConfigHoldMicros);
+    CHECK(GestureConfig::keyNamed("hold.micro", strlen("hold.micro")) == ConfigKeyCount);
+}
+
+TEST(config, errors)
+{
+    struct {
+        const char *text;
+        int line;
+    } bad[] = {
+        { "swipe.verticalThreshold = 650\nswipe.nonsense = 1\n", 2 },
+        { "\n\nswipe.verticalThreshold 650\n", 3 },
+        { "swipe.verticalThreshold = fast\n", 1 },
+        { "swipe.verticalThreshold = 650 mm\n", 1 },
+        { "scroll.fingers = 2.5\n", 1 },
+        { "filter.kind = median\n", 1 },
+        { "# ok\nswipe.verticalThreshold = nan\n", 2 },
+        { "swipe.horizontalThreshold = inf\n", 1 },
+        { "swipe.refractoryDownMicros = -1\n", 1 },
+        { "scroll.fingers = 99999999999\n", 1 },
+        { "swipe.releaseRatio = 1.5\n", 1 },
+    };
+    for (size_t i = 0; i < sizeof(bad) / sizeof(bad[0]); i++) {
+        GestureConfig config;
+        int line = 0;
+        CHECK(!config.parse(bad[i].text, &line));
+        CHECK(line == bad[i].line);
+    }
+
+    // the lines before the bad one are applied, the rest aren't
+    GestureConfig config;
+    const GestureConfig defaults;
+    CHECK(!config.parse("swipe.verticalThreshold = 650\nbogus = 1\nswipe.horizontalThreshold = 400\n"));
+    CHECK(config.swipe.verticalThreshold == 650);
+    CHECK(config.swipe.horizontalThreshold == defaults.swipe.horizontalThreshold);
+
+    // a store keeps its previous version when a load fails
+    ConfigStore store(defaults);
+    CHECK(store.load("swipe.verticalThreshold = 650\n"));
+    const uint64_t version = store.version();
+    int line = 0;
+    CHECK(!store.load("swipe.verticalThreshold = -650\n", &line));
+    CHECK(line == 1);
+    CHECK(store.version() == version);
+    CHECK(store.current().swipe.verticalThreshold == 650);
+}
+
+TEST(config, defaults)
+{
+    // a default config is what the recognizers start out with
+    const GestureConfig config;
+    const PinchRecognizer pinch;
+    const HoldRecognizer hold;
+    const TwoHandZoomRecognizer zoom;
+    const ScrollRecognizer scrolling;
+    SwipeGate gate;
+    const TemplateRecognizer templates(gate);
+    CHECK(config.pinchDistance == pinch.pinchDistance);
+    CHECK(config.pinchReleaseDistance == pinch.releaseDistance);
+    CHECK(config.holdMaxSpeed == hold.maxSpeed);
+    CHECK(config.holdMicros == hold.holdMicros);
+    CHECK(config.zoomRatio == zoom.zoomRatio);
+    CHECK(config.zoomMinDistance == zoom.minDistance);
+    CHECK(config.scrollFingers == scrolling.fingers);
+    CHECK(config.scrollDeadZone == scrolling.deadZone);
+    CHECK(config.templateWindowMicros == templates.windowMicros);
+    CHECK(config.templateMinPathLength == templates.minPathLength);
+    CHECK(config.templateMinSpeed == templates.minSpeed);
+    CHECK(config.templateMatchThreshold == templates.matchThreshold);
+}
@@ -0,0 +1,103 @@
+//
+//  DispatchTests.cpp
+//  OSXGestureControl
+//
+//  Copyright (c) 2013 Chris Willingham. All rights reserved.
+//
+
+#include "TestSupport.h"
+
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "../GestureController/Core/ActionDispatcher.h"
+
+using namespace GestureCore;
+
+//////////////////////////////////////////////////////////////////////////
+//ACTION DISPATCH
+static bool waitForActions(const ActionDispatcher &dispatcher, uint64_t count)
+{
+    for (int i = 0; i < 2000 && dispatcher.actionsPerformed() < count; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return dispatcher.actionsPerformed() >= count;
+}
+
+TEST(dispatch, order)
+{
+    const int64_t step = 2000;
+    RecordingActionSink sink;
+    ActionDispatcher dispatcher(sink);
+    dispatcher.start();
+    // two chords queued at once run back to back, never interleaved
+    CHECK(dispatcher.enqueue(ActionSequence::keyChord(55, 1, step)));
+    CHECK(dispatcher.enqueue(ActionSequence::keyChord(59, 2, step)));
+    CHECK(waitForActions(dispatcher, 8));
+    dispatcher.stop();
+
+    const std::vector<RecordingActionSink::Entry> entries = sink.entries();
+    CHECK(entries.size() == 8);
+    if (entries.size() != 8) {
+        return;
+    }
+    const int32_t codes[8] = { 55, 1, 55, 1, 59, 2, 59, 2 };
+    const bool downs[8] = { true, true, false, false, true, true, false, false };
+    for (int i = 0; i < 8; i++) {
+        CHECK(entries[i].action.kind == ActionKey);
+        CHECK(entries[i].action.code == codes[i]);
+        CHECK(entries[i].action.down == downs[i]);
+        if (i % 4 != 0) {
+            // steps within a chord are due step micros apart, and never run early
+            CHECK(entries[i].timeMicros - entries[i - 1].timeMicros >= step - 500);
+        }
+    }
+}
+
+TEST(dispatch, stopReleases)
+{
+    RecordingActionSink sink;
+    ActionDispatcher dispatcher(sink);
+    dispatcher.start();
+    // steps a second apart, stopped once the modifier is down: stop() lets
+    // go of the modifier but never presses the key or runs the command
+    ActionSequence sequence = ActionSequence::keyChord(55, 1, 1000000);
+    sequence.command(7, 1000000);
+    CHECK(dispatcher.enqueue(sequence));
+    CHECK(waitForActions(dispatcher, 1));
+    dispatcher.stop();
+    const std::vector<RecordingActionSink::Entry> entries = sink.entries();
+    CHECK(entries.size() == 2);
+    if (entries.size() == 2) {
+        CHECK(entries[0].action.code == 55 && entries[0].action.down);
+        CHECK(entries[1].action.code == 55 && !entries[1].action.down);
+    }
+    for (size_t i = 1; i < entries.size(); i++) {
+        CHECK(entries[i].action.kind == ActionKey && !entries[i].action.down);
+    }
+    CHECK(dispatcher.pendingSteps() == 0);
+
+    // stopped before anything was due, nothing at all is posted
+    RecordingActionSink idleSink;
+    ActionDispatcher idle(idleSink);
+    idle.start();
+    ActionSequence later;
+    later.keyDown(56, 1000000).command(7, 1000000).keyUp(56, 2000000);
+    CHECK(idle.enqueue(later));
+    idle.stop();
+    CHECK(idleSink.entries().empty());
+}
+
+TEST(dispatch, queueFull)
+{
+    RecordingActionSink sink;
+    ActionDispatcher dispatcher(sink);
+    // not started, so nothing drains: the queue holds MaxPendingSteps steps
+    const int chords = ActionDispatcher::MaxPendingSteps / 4;
+    for (int i = 0; i < chords; i++) {
+        CHECK(dispatcher.enqueue(ActionSequence::keyChord(55, i, 1000)));
+    }
+    CHECK(!dispatcher.enqueue(ActionSequence::keyChord(55, 1, 1000)));
+    CHECK(dispatcher.sequencesDropped() == 1);
+    CHECK(dispatcher.pendingSteps() == (size_t)ActionDispatcher::MaxPendingSteps);
+}
@@ -0,0 +1,109 @@
+//
+//  RecordingTests.cpp
+//  OSXGestureControl
+//
+//  Copyright (c) 2013 Chris Willingham. All rights reserved.
+//
+
+#include "TestSupport.h"
+
+#include <stdio.h>
+#include <unistd.h>
+#include <vector>
+#include "../GestureController/Core/FrameRecording.h"
+
+using namespace GestureCore;
+
+//////////////////////////////////////////////////////////////////////////
+//RECORDING
+TEST(recording, roundTrip)
+{
+    const std::string path = scratchName("/tmp/gesture-tests-", ".lprc");
+    unlink(path.c_str());
+    std::vector<FrameBuffer> frames;
+    frames.push_back(makeFrame(1, 0, 0));
+    frames.push_back(makeFrame(2, 1, 5));
+    frames.push_back(makeFrame(3, 2, 10));
+
+    FrameRecorder recorder;
+    CHECK(recorder.open(path.c_str()));
+    for (size_t i = 0; i < 2; i++) {
+        CHECK(recorder.write(frames[i].snapshot()));
+    }
+    recorder.close();
+    // reopening appends to the same recording
+    CHECK(recorder.open(path.c_str()));
+    CHECK(recorder.write(frames[2].snapshot()));
+    CHECK(recorder.framesWritten() == 1);
+    recorder.close();
+
+    RecordingFrameSource source;
+    CHECK(source.open(path.c_str()));
+    FrameSnapshot frame;
+    for (size_t i = 0; i < frames.size(); i++) {
+        CHECK(source.nextFrame(frame));
+        CHECK(sameFrame(frame, frames[i]));
+    }
+    CHECK(!source.nextFrame(frame));
+    source.rewind();
+    CHECK(source.nextFrame(frame) && frame.id == 1);
+    source.close();
+    unlink(path.c_str());
+}
+
+TEST(recording, truncated)
+{
+    const std::string path = scratchName("/tmp/gesture-tests-", ".lprc");
+    unlink(path.c_str());
+    FrameRecorder recorder;
+    CHECK(recorder.open(path.c_str()));
+    for (int64_t id = 1; id <= 3; id++) {
+        CHECK(recorder.write(makeFrame(id, 1, 5).snapshot()));
+    }
+    recorder.close();
+
+    // cut into the last record, as if the recorder was killed mid-write
+    FILE *file = fopen(path.c_str(), "rb");
+    CHECK(file != NULL);
+    fseek(file, 0, SEEK_END);
+    const long size = ftell(file);
+    fclose(file);
+    CHECK(truncate(path.c_str(), size - 20) == 0);
+
+    RecordingFrameSource source;
+    CHECK(source.open(path.c_str()));
+    FrameSnapshot frame;
+    int frames = 0;
+    while (source.nextFrame(frame)) {
+        frames++;
+        CHECK(frame.id == frames);
+    }
+    CHECK(frames == 2);
+    source.close();
+
+    // reopening drops the partial record, so frames appended after it replay
+    CHECK(recorder.open(path.c_str()));
+    CHECK(recorder.write(makeFrame(4, 2, 8).snapshot()));
+    recorder.close();
+    CHECK(source.open(path.c_str()));
+    const int64_t ids[3] = { 1, 2, 4 };
+    frames = 0;
+    while (source.nextFrame(frame)) {
+        CHECK(frames < 3 && frame.id == ids[frames]);
+        frames++;
+    }
+    CHECK(frames == 3);
+    source.close();
+
+    // too short to hold even the header
+    CHECK(truncate(path.c_str(), sizeof(RecordingHeader) - 1) == 0);
+    CHECK(!source.open(path.c_str()));
+
+    // not a recording at all
+    file = fopen(path.c_str(), "wb");
+    fputs("not a recording, but long enough to hold a header", file);
+    fclose(file);
+    CHECK(!source.open(path.c_str()));
+    CHECK(!recorder.open(path.c_str()));
+    unlink(path.c_str());
+}
@@ -0,0 +1,195 @@
+//
+//  ScrollTests.cpp
+//  OSXGestureControl
+//
+//  Copyright (c) 2013 Chris Willingham. All rights reserved.
+//
+
+#include "TestSupport.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "../GestureController/Core/ScrollEngine.h"
+
+using namespace GestureCore;
+
+// 1/64 s, exact in binary, so tracked offsets add up to whole pixels.
+static const int64_t FrameMicros = 15625;
+
+static ScrollParams testParams()
+{
+    ScrollParams params;
+    params.outputHz = 60;
+    params.gain = 1;
+    params.friction = 4;
+    params.stopSpeed = 20;
+    params.maxGapMicros = 100000;
+    return params;
+}
+
+static int32_t postedX(const RecordingActionSink &sink)
+{
+    const std::vector<RecordingActionSink::Entry> entries = sink.entries();
+    int32_t dx = 0;
+    for (size_t i = 0; i < entries.size(); i++) {
+        dx += entries[i].action.dx;
+    }
+    return dx;
+}
+
+//////////////////////////////////////////////////////////////////////////
+//SCROLL
+TEST(scroll, tracksWholePixels)
+{
+    ScrollEngine engine;
+    engine.setParams(testParams());
+    RecordingActionSink sink;
+    CHECK(!engine.isActive());
+    CHECK(!engine.tick(0, sink));
+
+    // 128 mm/s for 8 frames is 2 px a frame; the first only touches down
+    for (int i = 0; i <= 8; i++) {
+        engine.track(128, -64, i * FrameMicros);
+    }
+    CHECK(engine.isActive());
+    CHECK(engine.tick(1000, sink));
+    const std::vector<RecordingActionSink::Entry> entries = sink.entries();
+    CHECK(entries.size() == 1);
+    if (entries.size() == 1) {
+        CHECK(entries[0].action.kind == ActionScroll);
+        CHECK(entries[0].action.dx == 16 && entries[0].action.dy == -8);
+    }
+    // nothing new tracked, nothing posted
+    CHECK(!engine.tick(2000, sink));
+    CHECK(engine.eventsPosted() == 1);
+
+    // a gap longer than maxGapMicros doesn't scroll across it
+    engine.track(128, 0, 8 * FrameMicros + 200000);
+    CHECK(!engine.tick(3000, sink));
+}
+
+TEST(scroll, releaseCoasts)
+{
+    ScrollEngine engine;
+    engine.setParams(testParams());
+    RecordingActionSink sink;
+    for (int i = 0; i <= 32; i++) {
+        engine.track(500, 0, i * FrameMicros);
+    }
+    engine.release();
+    CHECK(engine.isActive());
+    int64_t now = 0;
+    engine.tick(now, sink);
+    const int32_t tracked = postedX(sink);
+    CHECK(tracked == 250);
+
+    // momentum keeps going the same way and decays to a stop
+    int ticks = 0;
+    while (engine.isActive() && ticks < 1000) {
+        now += 16667;
+        engine.tick(now, sink);
+        ticks++;
+    }
+    CHECK(!engine.isActive());
+    const int32_t coasted = postedX(sink) - tracked;
+    // about v / friction = 500 / 4 px, less what's left under stopSpeed
+    CHECK(coasted > 100 && coasted <= 125);
+    CHECK(ticks > 10);
+
+    // touching down again stops it
+    ScrollEngine caught;
+    caught.setParams(testParams());
+    for (int i = 0; i <= 8; i++) {
+        caught.track(500, 0, i * FrameMicros);
+    }
+    caught.release();
+    caught.track(0, 0, 9 * FrameMicros);
+    caught.tick(0, sink);
+    caught.tick(100000, sink);
+    caught.release();
+    caught.tick(200000, sink);
+    CHECK(!caught.isActive());
+}
+
+TEST(scroll, cancelDropsPending)
+{
+    ScrollEngine engine;
+    engine.setParams(testParams());
+    RecordingActionSink sink;
+    for (int i = 0; i <= 8; i++) {
+        engine.track(500, 0, i * FrameMicros);
+    }
+    engine.cancel();
+    CHECK(!engine.tick(0, sink));
+    CHECK(!engine.tick(100000, sink));
+    CHECK(!engine.isActive());
+    CHECK(sink.entries().empty());
+
+    // and tracking afterwards starts from nothing
+    for (int i = 0; i <= 2; i++) {
+        engine.track(128, 0, (20 + i) * FrameMicros);
+    }
+    CHECK(engine.tick(200000, sink));
+    CHECK(postedX(sink) == 4);
+}
+
+TEST(scroll, paramsClamped)
+{
+    ScrollEngine engine;
+    ScrollParams params = testParams();
+    params.outputHz = 0;
+    params.gain = NAN;
+    params.friction = -3;
+    params.stopSpeed = 0;
+    params.maxGapMicros = -1;
+    engine.setParams(params);
+    const ScrollParams clamped = engine.params();
+    CHECK(clamped.outputHz == 1);
+    CHECK(clamped.gain == 0);
+    CHECK(clamped.friction == 0);
+    CHECK(clamped.stopSpeed > 0);
+    CHECK(clamped.maxGapMicros == 0);
+
+    // friction 0 means no momentum, rather than a NaN or a runaway
+    params = testParams();
+    params.friction = 0;
+    engine.setParams(params);
+    RecordingActionSink sink;
+    for (int i = 0; i <= 8; i++) {
+        engine.track(500, 0, i * FrameMicros);
+    }
+    engine.release();
+    engine.tick(0, sink);
+    CHECK(!engine.tick(100000, sink));
+    CHECK(!engine.isActive());
+    CHECK(postedX(sink) == 62);
+}
+
+TEST(scroll, outputRate)
+{
+    ScrollEngine engine;
+    ScrollParams params = testParams();
+    params.outputHz = 100;
+    params.friction = 0;
+    engine.setParams(params);
+    RecordingActionSink sink;
+    engine.start(sink);
+    // 200 ms of frames at 1 kHz, each worth one pixel
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int i = 0; i <= 200; i++) {
+        engine.track(1000, 0, i * 1000);
+        std::this_thread::sleep_until(start + std::chrono::milliseconds(i + 1));
+    }
+    engine.release();
+    for (int i = 0; i < 1000 && postedX(sink) < 199; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    engine.stop();
+    // 1 ms isn't exact in binary, so the last fraction may still be pending
+    CHECK(abs(postedX(sink) - 200) <= 1);
+    // coalesced to about 100 Hz, nowhere near one event per frame
+    CHECK(engine.eventsPosted() >= 2 && engine.eventsPosted() <= 40);
+}
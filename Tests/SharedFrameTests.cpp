@@ -0,0 +1,103 @@
+//
+//  SharedFrameTests.cpp
+//  OSXGestureControl
+//
+//  Copyright (c) 2013 Chris Willingham. All rights reserved.
+//
+
+#include "TestSupport.h"
+
+#include "../GestureController/Core/SharedFrame.h"
+
+using namespace GestureCore;
+
+//////////////////////////////////////////////////////////////////////////
+//SHARED FRAME
+TEST(sharedFrame, counting)
+{
+    const std::string name = scratchName("/gesture-tests.", "");
+    SharedFrameReader reader;
+    CHECK(!reader.open(name.c_str()));
+
+    SharedFramePublisher publisher;
+    CHECK(publisher.open(name.c_str()));
+    CHECK(reader.open(name.c_str()));
+    CHECK(reader.writerOpen());
+
+    FrameBuffer frame;
+    CHECK(reader.readFrame(frame) == SharedReadEmpty);
+
+    FrameBuffer published = makeFrame(1, 1, 5);
+    publisher.publishFrame(published.snapshot());
+    CHECK(reader.readFrame(frame) == SharedReadNew);
+    CHECK(sameFrame(frame.snapshot(), published));
+    CHECK(reader.readFrame(frame) == SharedReadUnchanged);
+    CHECK(reader.missedFrames() == 0);
+
+    // three more published between reads: the latest is read, two missed
+    for (int64_t id = 2; id <= 4; id++) {
+        published = makeFrame(id, 2, 8);
+        publisher.publishFrame(published.snapshot());
+    }
+    CHECK(reader.readFrame(frame) == SharedReadNew);
+    CHECK(frame.id == 4);
+    CHECK(sameFrame(frame.snapshot(), published));
+    CHECK(reader.missedFrames() == 2);
+    CHECK(publisher.framesPublished() == 4);
+
+    // in place, without a copy
+    publisher.publishFrame(makeFrame(5, 1, 1).snapshot());
+    const uint64_t sequence = reader.beginFrame();
+    const int64_t id = reader.frame().id;
+    CHECK(reader.endFrame(sequence));
+    CHECK(id == 5);
+    CHECK(reader.readFrame(frame) == SharedReadUnchanged);
+    CHECK(reader.tornReads() == 0);
+
+    // a reader opened late doesn't count what came before it as missed
+    SharedFrameReader late;
+    CHECK(late.open(name.c_str()));
+    CHECK(late.readFrame(frame) == SharedReadUnchanged);
+    publisher.publishFrame(makeFrame(6, 1, 1).snapshot());
+    CHECK(late.readFrame(frame) == SharedReadNew);
+    CHECK(late.missedFrames() == 0);
+
+    publisher.close();
+    CHECK(!reader.writerOpen());
+}
+
+TEST(sharedFrame, events)
+{
+    const std::string name = scratchName("/gesture-tests.", "");
+    SharedFramePublisher publisher;
+    CHECK(publisher.open(name.c_str()));
+    SharedFrameReader reader;
+    CHECK(reader.open(name.c_str()));
+
+    SharedGestureEvent events[MaxSharedEvents * 2];
+    CHECK(reader.readEvents(events, MaxSharedEvents) == 0);
+
+    GestureEvent event;
+    for (int i = 0; i < 10; i++) {
+        event.frameId = i;
+        event.direction = (Direction)(i % 4);
+        publisher.publishEvent(event);
+    }
+    // in order, capacity at a time
+    CHECK(reader.readEvents(events, 4) == 4);
+    CHECK(events[0].frameId == 0 && events[3].frameId == 3);
+    CHECK(reader.readEvents(events, MaxSharedEvents) == 6);
+    CHECK(events[0].frameId == 4 && events[5].frameId == 9);
+    CHECK(events[5].direction == Up + 1);
+    CHECK(reader.missedEvents() == 0);
+
+    // wrapping the ring loses the oldest
+    for (int i = 10; i < 10 + MaxSharedEvents + 5; i++) {
+        event.frameId = i;
+        publisher.publishEvent(event);
+    }
+    CHECK(reader.readEvents(events, MaxSharedEvents * 2) == MaxSharedEvents);
+    CHECK(events[0].frameId == 15);
+    CHECK(reader.missedEvents() == 5);
+    CHECK(publisher.eventsPublished() == 10 + MaxSharedEvents + 5);
+}
@@ -0,0 +1,127 @@
+//
+//  TestSupport.cpp
+//  OSXGestureControl
+//
+//  Copyright (c) 2013 Chris Willingham. All rights reserved.
+//
+//  Behaviour tests for the portable C++ core. Runs every registered test
+//  and exits non-zero if any check failed.
+//
+//    gesture-tests [--filter=substring]
+//
+
+#include "TestSupport.h"
+
+#include <string.h>
+#include <unistd.h>
+#include <vector>
+
+namespace GestureCore {
+
+int checkFailures = 0;
+
+struct Test {
+    const char *name;
+    TestFunction run;
+};
+
+// Registrations run during static initialization, in whatever order the
+// files were linked, so the list can't be a plain global.
+static std::vector<Test> &registeredTests()
+{
+    static std::vector<Test> tests;
+    return tests;
+}
+
+TestRegistration::TestRegistration(const char *name, TestFunction run)
+{
+    Test test = { name, run };
+    registeredTests().push_back(test);
+}
+
+std::string scratchName(const char *prefix, const char *suffix)
+{
+    char name[64];
+    snprintf(name, sizeof(name), "%s%d%s", prefix, (int)getpid(), suffix);
+    return name;
+}
+
+FrameBuffer makeFrame(int64_t id, uint32_t hands, uint32_t pointables)
+{
+    FrameBuffer frame;
+    frame.id = id;
+    frame.timestamp = id * 8700;
+    frame.handCount = hands;
+    frame.pointableCount = pointables;
+    for (uint32_t h = 0; h < hands; h++) {
+        HandSnapshot &hand = frame.hands[h];
+        memset(&hand, 0, sizeof(hand));
+        hand.id = (int32_t)(id * 10 + h);
+        hand.palmPosition.x = (float)id;
+        hand.sphereRadius = 50 + h;
+    }
+    for (uint32_t i = 0; i < pointables; i++) {
+        frame.pointableIds[i] = (int32_t)(id * 100 + i);
+        frame.pointableHandIds[i] = hands > 0 ? frame.hands[i % hands].id : -1;
+        frame.pointableHandIndices[i] = hands > 0 ? (uint8_t)(i % hands) : NoHandIndex;
+        frame.tipPositions.set(i, Leap::Vector((float)i, (float)id, -10));
+        frame.tipVelocities.set(i, Leap::Vector(100, (float)-i, 0));
+        frame.directions.set(i, Leap::Vector(0, 0, -1));
+        frame.widths[i] = 15;
+        frame.lengths[i] = 50 + (float)i;
+        frame.flags[i] = PointableIsFinger;
+    }
+    return frame;
+}
+
+bool sameFrame(const FrameSnapshot &a, const FrameBuffer &b)
+{
+    if (a.id != b.id || a.timestamp != b.timestamp || a.handCount != b.handCount ||
+        a.pointableCount != b.pointableCount || a.gestureCount != b.gestureCount) {
+        return false;
+    }
+    if (memcmp(a.hands, b.hands, a.handCount * sizeof(HandSnapshot)) != 0) {
+        return false;
+    }
+    for (uint32_t i = 0; i < a.pointableCount; i++) {
+        if (a.pointables.ids[i] != b.pointableIds[i] || a.pointables.handIds[i] != b.pointableHandIds[i] ||
+            a.pointables.handIndices[i] != b.pointableHandIndices[i] ||
+            a.pointables.tipPositions.y[i] != b.tipPositions.y[i] ||
+            a.pointables.tipVelocities.y[i] != b.tipVelocities.y[i] ||
+            a.pointables.directions.z[i] != b.directions.z[i] ||
+            a.pointables.lengths[i] != b.lengths[i] || a.pointables.flags[i] != b.flags[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}
+
+using namespace GestureCore;
+
+int main(int argc, char **argv)
+{
+    std::string filter;
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--filter=", 9) == 0) {
+            filter = argv[i] + 9;
+        }
+    }
+    const std::vector<Test> &tests = registeredTests();
+    int failed = 0;
+    int run = 0;
+    for (size_t i = 0; i < tests.size(); i++) {
+        if (!filter.empty() && std::string(tests[i].name).find(filter) == std::string::npos) {
+            continue;
+        }
+        const int before = checkFailures;
+        tests[i].run();
+        run++;
+        const bool passed = checkFailures == before;
+        printf("%-28s %s\n", tests[i].name, passed ? "ok" : "FAILED");
+        failed += passed ? 0 : 1;
+    }
+    printf("%d of %d tests passed\n", run - failed, run);
+    return failed == 0 ? 0 : 1;
+}
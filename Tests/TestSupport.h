@@ -0,0 +1,54 @@
+//
+//  TestSupport.h
+//  OSXGestureControl
+//
+//  Copyright (c) 2013 Chris Willingham. All rights reserved.
+//
+//  The little there is of a test framework: CHECK, which reports a failed
+//  condition and carries on, TEST, which registers a function with the
+//  runner in TestSupport.cpp, and frames built to be compared afterwards.
+//
+
+#ifndef OSXGestureControl_TestSupport_h
+#define OSXGestureControl_TestSupport_h
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include "../GestureController/Core/FrameSnapshot.h"
+
+namespace GestureCore {
+
+extern int checkFailures;
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            printf("    %s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+            GestureCore::checkFailures++; \
+        } \
+    } while (0)
+
+typedef void (*TestFunction)();
+
+struct TestRegistration {
+    TestRegistration(const char *name, TestFunction run);
+};
+
+// TEST(config, parse) { ... } runs as "config/parse".
+#define TEST(group, name) \
+    static void test_##group##_##name(); \
+    static GestureCore::TestRegistration registration_##group##_##name(#group "/" #name, test_##group##_##name); \
+    static void test_##group##_##name()
+
+// A scratch path or shm name unique to this process.
+std::string scratchName(const char *prefix, const char *suffix);
+
+// A frame whose contents all follow from id, so a replayed or shared copy
+// can be checked field by field.
+FrameBuffer makeFrame(int64_t id, uint32_t hands, uint32_t pointables);
+bool sameFrame(const FrameSnapshot &a, const FrameBuffer &b);
+
+}
+
+#endif